@@ -2,39 +2,21 @@
 #include "app/SimulationController.h"
 #include "app/Windowing.h"
 
-#include "sim/DefaultWorld.h"
-
 namespace app_loop {
 
 SimulationController::SimulationController(sim::World world)
-    : world_(std::move(world)) {}
-
-std::vector<sim::Body>& SimulationController::mutableBodies() {
-    return world_.bodies();
-}
+    : thread_(std::move(world)) {}
 
 const std::vector<sim::Body>& SimulationController::bodies() const {
-    return world_.bodies();
+    return thread_.snapshot().bodies;
 }
 
 bool SimulationController::hasBodies() const {
-    return !world_.bodies().empty();
+    return !thread_.snapshot().bodies.empty();
 }
 
 void SimulationController::applySettings(const ui::SimulationSettings& simSettings) {
-    world_.params().enableGravity = simSettings.gravityEnabled;
-    world_.params().G = simSettings.gravityStrength;
-    world_.params().enableCollisions = simSettings.collisionsEnabled;
-    world_.params().velocityIterations = simSettings.velocityIterations;
-    world_.params().positionIterations = simSettings.positionIterations;
-    world_.params().restitution = simSettings.globalRestitution;
-}
-
-void SimulationController::syncPreviousState_() {
-    for (auto& body : world_.bodies()) {
-        body.prevPosition = body.position;
-        body.prevOrientation = body.orientation;
-    }
+    commands_.settings = simSettings;
 }
 
 GlfwSession::~GlfwSession() {
@@ -92,7 +74,8 @@ void SimulationController::reset(
     RuntimeState& runtime,
     const ui::SimulationSettings& simSettings)
 {
-    world_ = sim::makeDefaultWorld();
+    // The simulation thread builds the new world when it sees the request.
+    ++commands_.resetRequests;
     applySettings(simSettings);
     runtime.simulation.fixedStep.lastFrameTime = glfwGetTime();
     runtime.simulation.fixedStep.accumulator = 0.0;
@@ -103,11 +86,7 @@ void SimulationController::reset(
     runtime.simulation.speedUpWasDown = false;
     runtime.simulation.speedResetWasDown = false;
     runtime.focus = {};
-    runtime.simulation.elapsedTime = 0.0;
-    ++runtime.simulation.sceneRevision;
-    ++runtime.pathHistoryRevision;
-    runtime.pathHistory.clear();
-    syncPreviousState_();
+    // Trails and the clock follow the old world until update() picks up the new one.
 }
 
 } // namespace app_loop
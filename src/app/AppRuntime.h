@@ -42,6 +42,7 @@ struct RuntimeState {
         bool speedResetWasDown = false;
         bool simFrozen = false;
         double simSpeed = 1.0;
+        double achievedSpeed = 0.0; // As measured by the simulation thread; 0 while not running
         double elapsedTime = 0.0;
         std::uint64_t sceneRevision = 1;
 
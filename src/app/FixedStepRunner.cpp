@@ -63,7 +63,6 @@ void SimulationController::handleHotkeys(
     if (!pauseMenuOpen && freezeDown && !runtime.simulation.freezeWasDown) {
         runtime.simulation.simFrozen = !runtime.simulation.simFrozen;
         resetFixedStepState(runtime);
-        syncPreviousState_();
     }
     runtime.simulation.freezeWasDown = freezeDown;
 
@@ -139,40 +138,38 @@ bool cameraTranslationPressed(
         input::isBindingPressed(window, controls.moveDown);
 }
 
-void SimulationController::step(RuntimeState& runtime, const bool pauseMenuOpen, const double frameTime) {
-    auto& fixedStep = runtime.simulation.fixedStep;
-    if (runtime.simulation.simFrozen || pauseMenuOpen) {
-        fixedStep.accumulator = 0.0;
-        fixedStep.alpha = 0.0;
-        return;
-    }
-
-    if (runtime.simulation.simSpeed <= 0.0) {
-        fixedStep.accumulator = 0.0;
-        fixedStep.alpha = 0.0;
-        return;
+void SimulationController::update(RuntimeState& runtime, const bool pauseMenuOpen) {
+    const double simSpeed = runtime.simulation.simSpeed;
+    commands_.simSpeed = simSpeed;
+    commands_.running = !runtime.simulation.simFrozen && !pauseMenuOpen && simSpeed > 0.0 && std::isfinite(simSpeed);
+    thread_.publishCommands(commands_);
+    thread_.acquireSnapshot();
+
+    const SimulationSnapshot& snapshot = thread_.snapshot();
+    if (snapshot.resetRequests != snapshotResetRequests_) {
+        // First snapshot of a reset world: trails of the old one must not run into it.
+        snapshotResetRequests_ = snapshot.resetRequests;
+        ++runtime.pathHistoryRevision;
+        runtime.pathHistory.clear();
     }
+    runtime.simulation.sceneRevision = snapshot.sceneRevision;
+    runtime.simulation.elapsedTime = snapshot.elapsedTime;
 
-    const double scaledFrameTime = std::max(0.0, frameTime * runtime.simulation.simSpeed);
-    if (!std::isfinite(scaledFrameTime)) {
+    auto& fixedStep = runtime.simulation.fixedStep;
+    if (!commands_.running || !snapshot.running) {
+        runtime.simulation.achievedSpeed = 0.0;
         fixedStep.accumulator = 0.0;
         fixedStep.alpha = 0.0;
         return;
     }
-
-    fixedStep.accumulator += scaledFrameTime;
-
-    int steps = 0;
-    while (fixedStep.accumulator >= kFixedDt && steps < kInternalMaxPhysicsStepsPerFrame) {
-        syncPreviousState_();
-        world_.step(kFixedDt);
-        ++runtime.simulation.sceneRevision;
-        runtime.simulation.elapsedTime += kFixedDt;
-        fixedStep.accumulator -= kFixedDt;
-        ++steps;
-    }
-
-    fixedStep.alpha = std::clamp(fixedStep.accumulator / kFixedDt, 0.0, 1.0);
+    runtime.simulation.achievedSpeed = snapshot.achievedSpeed;
+
+    // The snapshot holds the states before and after its last step; time keeps running on the
+    // simulation thread, so the alpha between them follows the clock until the next snapshot.
+    const double sincePublished = std::max(0.0, glfwGetTime() - snapshot.publishedAt) * simSpeed;
+    fixedStep.accumulator = snapshot.accumulator + sincePublished;
+    const double stepDt = snapshot.stepDt > 0.0 ? snapshot.stepDt : kFixedDt;
+    fixedStep.alpha = std::clamp(fixedStep.accumulator / stepDt, 0.0, 1.0);
 }
 
 } // namespace app_loop
@@ -10,7 +10,6 @@ void updatePauseMenu(
     app_loop::RuntimeState& runtime,
     input::ControlBindings& controls,
     ui::PauseMenu& pauseMenu,
-    app_loop::SimulationController& simulation,
     const std::string& controlsConfigPath,
     const float scrollDeltaY)
 {
@@ -22,8 +21,7 @@ void updatePauseMenu(
         runtime.input.firstMouse,
         runtime.simulation.fixedStep.lastFrameTime,
         runtime.simulation.fixedStep.accumulator,
-        runtime.simulation.fixedStep.alpha,
-        simulation.mutableBodies());
+        runtime.simulation.fixedStep.alpha);
     pauseMenu.handlePointerInput(window, controls, controlsConfigPath, scrollDeltaY);
     pauseMenu.handlePressedKey(window, pressedKey, controls, controlsConfigPath);
     pauseMenu.updateContinuousInput(window, controls);
@@ -46,7 +44,7 @@ void processInputStage(
 
     const float scrollDeltaY = static_cast<float>(consumeScrollDeltaY(appState));
     runtime.input.scrollDeltaY = scrollDeltaY;
-    updatePauseMenu(window, appState, runtime, controls, pauseMenu, simulation, controlsConfigPath, scrollDeltaY);
+    updatePauseMenu(window, appState, runtime, controls, pauseMenu, controlsConfigPath, scrollDeltaY);
     if (pauseMenu.consumeResetWorldRequest()) {
         simulation.reset(runtime, pauseMenu.simulationSettings());
     }
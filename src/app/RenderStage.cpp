@@ -116,6 +116,7 @@ void renderStage(
         appState.framebufferSize,
         runtime.simulation.simFrozen,
         runtime.simulation.simSpeed,
+        runtime.simulation.achievedSpeed,
         runtime.simulation.elapsedTime,
         runtime.fps.displayed,
         interfaceSettings.drawPath,
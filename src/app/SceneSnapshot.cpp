@@ -4,6 +4,7 @@
 
 #include "app/AppRuntime.h"
 #include "app/SimulationController.h"
+#include "sim/Material.h"
 #include "sim/Quaternion.h"
 
 namespace app_loop {
@@ -64,7 +65,7 @@ void buildSceneSnapshot(
             .angularSpeedMagnitude = static_cast<float>(bodies[i].angularVelocity.magnitude()),
             .invMass = bodies[i].invMass,
             .bodyId = bodies[i].id,
-            .materialName = bodies[i].materialName,
+            .materialName = sim::materialName(bodies[i].material),
         };
 
         glm::mat4 model(1.0f);
@@ -1,9 +1,11 @@
 #ifndef PHYSICS3D_APP_SIMULATIONCONTROLLER_H
 #define PHYSICS3D_APP_SIMULATIONCONTROLLER_H
 
+#include <cstdint>
 #include <vector>
 
 #include "app/AppRuntime.h"
+#include "app/SimulationThread.h"
 #include "input/Bindings.h"
 #include "sim/World.h"
 #include "ui/PauseMenu.h"
@@ -12,11 +14,12 @@ struct GLFWwindow;
 
 namespace app_loop {
 
+// Frame-loop side of the simulation. The world itself steps on a SimulationThread; bodies() is
+// the snapshot picked up by the last update().
 class SimulationController {
 public:
     explicit SimulationController(sim::World world);
 
-    std::vector<sim::Body>& mutableBodies();
     [[nodiscard]] const std::vector<sim::Body>& bodies() const;
     [[nodiscard]] bool hasBodies() const;
 
@@ -27,13 +30,15 @@ public:
         const ui::SimulationSettings& simSettings,
         bool pauseMenuOpen,
         RuntimeState& runtime);
-    void step(RuntimeState& runtime, bool pauseMenuOpen, double frameTime);
+    // Hands this frame's commands to the simulation thread, picks up its latest snapshot and
+    // derives the interpolation alpha for the current time.
+    void update(RuntimeState& runtime, bool pauseMenuOpen);
     void reset(RuntimeState& runtime, const ui::SimulationSettings& simSettings);
 
 private:
-    sim::World world_;
-
-    void syncPreviousState_();
+    SimulationCommands commands_{};
+    std::uint64_t snapshotResetRequests_ = 0; // Of the last snapshot update() picked up
+    SimulationThread thread_;
 };
 
 } // namespace app_loop
@@ -66,7 +66,7 @@ void updateFrameState(
     } else if (!runtime.focus.camera.active) {
         app_loop::updateCamera(window, controls, cameraSettings, runtime, cameraFrameTime, cam);
     }
-    simulation.step(runtime, pauseMenu.isOpen(), frameTime);
+    simulation.update(runtime, pauseMenu.isOpen());
 
     if (runtime.focus.camera.active && runtime.input.mouseCaptured) {
         render_scene::SceneSnapshot focusSnapshot{};
@@ -0,0 +1,206 @@
+#include "app/SimulationThread.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+#include "app/AppRuntime.h"
+#include "sim/DefaultWorld.h"
+
+namespace app_loop {
+namespace {
+
+// Longest the thread sleeps before it looks at new commands again.
+constexpr double kIdlePollInterval = 0.002;
+// Longest a batch of steps runs before its result is published.
+constexpr double kMaxBatchWallTime = 1.0 / 120.0;
+// simSpeed from which steps span several kFixedDt.
+constexpr double kTimeWarpSpeed = 16.0;
+// Most wall-clock time the thread may owe in steps before simulated time is dropped.
+constexpr double kMaxSimulationDebt = 0.25;
+// Wall-clock time the achieved speed is averaged over.
+constexpr double kSpeedWindow = 0.5;
+
+void applySimulationSettings(sim::World& world, const ui::SimulationSettings& simSettings) {
+    world.params().enableGravity = simSettings.gravityEnabled;
+    world.params().G = simSettings.gravityStrength;
+    world.params().enableCollisions = simSettings.collisionsEnabled;
+    world.params().velocityIterations = simSettings.velocityIterations;
+    world.params().positionIterations = simSettings.positionIterations;
+    world.params().restitution = simSettings.globalRestitution;
+}
+
+void sleepFor(const double seconds) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(std::max(0.0, seconds)));
+}
+
+} // namespace
+
+SimulationThread::SimulationThread(sim::World world)
+    : world_(std::move(world))
+{
+    // The first snapshot is published before the thread starts, so the frame loop never sees
+    // an empty scene.
+    lastTime_ = glfwGetTime();
+    stepDt_ = kFixedDt;
+    resetSpeedWindow_(lastTime_);
+    syncPreviousState_();
+    publishSnapshot_(lastTime_);
+    snapshots_.acquire();
+    thread_ = std::thread([this]() { run_(); });
+}
+
+SimulationThread::~SimulationThread() {
+    stopRequested_.store(true, std::memory_order_relaxed);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void SimulationThread::publishCommands(const SimulationCommands& commands) {
+    commands_.back() = commands;
+    commands_.publish();
+}
+
+bool SimulationThread::acquireSnapshot() {
+    return snapshots_.acquire();
+}
+
+const SimulationSnapshot& SimulationThread::snapshot() const {
+    return snapshots_.front();
+}
+
+void SimulationThread::run_() {
+    while (!stopRequested_.load(std::memory_order_relaxed)) {
+        const double now = glfwGetTime();
+        if (commands_.acquire()) {
+            applyCommands_(commands_.front(), now);
+        }
+        if (!applied_.running) {
+            lastTime_ = now;
+            resetSpeedWindow_(now);
+            sleepFor(kIdlePollInterval);
+            continue;
+        }
+        advance_(now);
+    }
+}
+
+void SimulationThread::applyCommands_(const SimulationCommands& commands, const double now) {
+    const bool reset = commands.resetRequests != applied_.resetRequests;
+    const bool runningChanged = commands.running != applied_.running;
+    applied_ = commands;
+    if (reset) {
+        world_ = sim::makeDefaultWorld();
+        elapsedTime_ = 0.0;
+        ++sceneRevision_;
+    }
+    applySimulationSettings(world_, applied_.settings);
+
+    if (reset || runningChanged) {
+        // Start over from rest: nothing owed, nothing left to interpolate.
+        accumulator_ = 0.0;
+        lastTime_ = now;
+        resetSpeedWindow_(now);
+        syncPreviousState_();
+        publishSnapshot_(now);
+    }
+}
+
+void SimulationThread::advance_(const double now) {
+    const double scaledTime = std::max(0.0, (now - lastTime_) * applied_.simSpeed);
+    lastTime_ = now;
+    if (!std::isfinite(scaledTime)) {
+        accumulator_ = 0.0;
+        return;
+    }
+    accumulator_ += scaledTime;
+    limitDebt_();
+
+    const double stepDt = applied_.simSpeed >= kTimeWarpSpeed ? warpStepDt_() : kFixedDt;
+    int steps = static_cast<int>(std::min<double>(std::floor(accumulator_ / stepDt), kInternalMaxPhysicsStepsPerFrame));
+    if (wallCostPerSimSecond_ > 0.0) {
+        // One batch should take about kMaxBatchWallTime at the measured cost.
+        const double affordable = std::floor(kMaxBatchWallTime / (wallCostPerSimSecond_ * stepDt));
+        steps = std::min(steps, static_cast<int>(std::clamp(affordable, 1.0, 1e6)));
+    }
+    if (steps > 0) {
+        world_.advance(steps, stepDt);
+        sceneRevision_ += static_cast<std::uint64_t>(steps);
+        elapsedTime_ += steps * stepDt;
+        accumulator_ -= steps * stepDt;
+    }
+    measureSpeed_(now, steps * stepDt, glfwGetTime() - now);
+
+    if (steps > 0) {
+        stepDt_ = stepDt;
+        publishSnapshot_(now);
+        return;
+    }
+    // Nothing due yet: sleep until the next step is, but keep polling commands.
+    sleepFor(std::min(kIdlePollInterval, (stepDt - accumulator_) / applied_.simSpeed));
+}
+
+double SimulationThread::warpStepDt_() const {
+    // As many fixed steps as the world runs as substeps of one call, so every substep stays at
+    // most maxSubstepDt long.
+    const sim::World::Params& params = world_.params();
+    const int substeps = std::clamp(params.maxSubsteps, 1, sim::World::Params::kDefaultMaxSubsteps);
+    const double maxSubstepDt = std::isfinite(params.maxSubstepDt) && params.maxSubstepDt > 0.0
+        ? static_cast<double>(params.maxSubstepDt)
+        : sim::World::Params::kDefaultMaxSubstepDt;
+    const double fixedSteps = std::floor(substeps * maxSubstepDt / kFixedDt + 1e-9);
+    return std::max(1.0, fixedSteps) * kFixedDt;
+}
+
+void SimulationThread::limitDebt_() {
+    if (wallCostPerSimSecond_ <= 0.0) {
+        return;
+    }
+    const double maxDebt = std::max(kFixedDt, kMaxSimulationDebt / wallCostPerSimSecond_);
+    accumulator_ = std::min(accumulator_, maxDebt);
+}
+
+void SimulationThread::measureSpeed_(const double now, const double simulated, const double wallTime) {
+    if (simulated > 0.0 && wallTime > 0.0) {
+        const double cost = wallTime / simulated;
+        wallCostPerSimSecond_ = wallCostPerSimSecond_ > 0.0 ? 0.8 * wallCostPerSimSecond_ + 0.2 * cost : cost;
+    }
+    speedWindowSimTime_ += simulated;
+    if (now - speedWindowStart_ >= kSpeedWindow) {
+        achievedSpeed_ = speedWindowSimTime_ / (now - speedWindowStart_);
+        speedWindowStart_ = now;
+        speedWindowSimTime_ = 0.0;
+    }
+}
+
+void SimulationThread::resetSpeedWindow_(const double now) {
+    speedWindowStart_ = now;
+    speedWindowSimTime_ = 0.0;
+    achievedSpeed_ = 0.0;
+}
+
+void SimulationThread::syncPreviousState_() {
+    for (auto& body : world_.bodies()) {
+        body.prevPosition = body.position;
+        body.prevOrientation = body.orientation;
+    }
+}
+
+void SimulationThread::publishSnapshot_(const double now) {
+    SimulationSnapshot& snapshot = snapshots_.back();
+    const std::vector<sim::Body>& bodies = std::as_const(world_).bodies();
+    snapshot.bodies.assign(bodies.begin(), bodies.end());
+    snapshot.sceneRevision = sceneRevision_;
+    snapshot.resetRequests = applied_.resetRequests;
+    snapshot.elapsedTime = elapsedTime_;
+    snapshot.accumulator = accumulator_;
+    snapshot.stepDt = stepDt_;
+    snapshot.publishedAt = now;
+    snapshot.achievedSpeed = achievedSpeed_;
+    snapshot.running = applied_.running;
+    snapshots_.publish();
+}
+
+} // namespace app_loop
@@ -0,0 +1,92 @@
+#ifndef PHYSICS3D_APP_SIMULATIONTHREAD_H
+#define PHYSICS3D_APP_SIMULATIONTHREAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "sim/TripleBuffer.h"
+#include "sim/World.h"
+#include "ui/PauseMenu.h"
+
+namespace app_loop {
+
+// What the frame loop wants from the simulation. Republished whole every frame.
+struct SimulationCommands {
+    ui::SimulationSettings settings{};
+    double simSpeed = 1.0;
+    bool running = false; // Not frozen, no pause menu, positive speed
+    std::uint64_t resetRequests = 0; // Counter, so a request survives skipped publications
+};
+
+// Body state after the most recent step. Every body carries the state before that step too
+// (prevPosition, prevOrientation), so one snapshot is enough to interpolate a frame.
+struct SimulationSnapshot {
+    std::vector<sim::Body> bodies{};
+    std::uint64_t sceneRevision = 1;
+    std::uint64_t resetRequests = 0; // The SimulationCommands counter this world was built for
+    double elapsedTime = 0.0;
+    double accumulator = 0.0; // Simulated time owed after the last step, as of publishedAt
+    double stepDt = 0.0; // Length of the last step, which interpolation spans
+    double publishedAt = 0.0; // glfwGetTime()
+    double achievedSpeed = 0.0; // Simulated over wall-clock time, measured over the last window
+    bool running = false;
+};
+
+// Owns the world and steps it at kFixedDt on a dedicated thread, paced by wall-clock time scaled
+// by simSpeed. The frame loop talks to it only through two triple buffers, so neither side ever
+// blocks the other: a slow step delays the next snapshot, not the next frame.
+//
+// From kTimeWarpSpeed on, each World::step covers several kFixedDt and the world splits it into
+// substeps no longer than its maxSubstepDt, which saves the per-step bookkeeping of the calls it
+// replaces. In either mode the thread never owes more simulated time than it can catch up on in
+// kMaxSimulationDebt of wall-clock time at the measured step cost; beyond that, time is dropped
+// and the achieved speed in the snapshot falls below the requested one.
+class SimulationThread {
+public:
+    explicit SimulationThread(sim::World world);
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Frame-loop side.
+    void publishCommands(const SimulationCommands& commands);
+    bool acquireSnapshot();
+    [[nodiscard]] const SimulationSnapshot& snapshot() const;
+
+private:
+    sim::World world_;
+    sim::TripleBuffer<SimulationCommands> commands_{};
+    sim::TripleBuffer<SimulationSnapshot> snapshots_{};
+    std::atomic<bool> stopRequested_{false};
+
+    // Owned by the simulation thread once it runs.
+    SimulationCommands applied_{};
+    std::uint64_t sceneRevision_ = 1;
+    double elapsedTime_ = 0.0;
+    double accumulator_ = 0.0;
+    double lastTime_ = 0.0;
+    double stepDt_ = 0.0;
+    double wallCostPerSimSecond_ = 0.0; // Smoothed
+    double speedWindowStart_ = 0.0;
+    double speedWindowSimTime_ = 0.0;
+    double achievedSpeed_ = 0.0;
+
+    std::thread thread_{};
+
+    void run_();
+    void applyCommands_(const SimulationCommands& commands, double now);
+    void advance_(double now);
+    [[nodiscard]] double warpStepDt_() const;
+    void limitDebt_();
+    void measureSpeed_(double now, double simulated, double wallTime);
+    void resetSpeedWindow_(double now);
+    void syncPreviousState_();
+    void publishSnapshot_(double now);
+};
+
+} // namespace app_loop
+
+#endif // PHYSICS3D_APP_SIMULATIONTHREAD_H
@@ -25,6 +25,7 @@ struct FrameInput {
     FramebufferSize framebufferSize{};
     bool simFrozen = false;
     double simSpeed = 1.0;
+    double achievedSimSpeed = 0.0;
     double simElapsed = 0.0;
     double fps = 0.0;
     bool showWorldPaths = false;
@@ -281,6 +281,7 @@ void FrameRenderer::renderOverlayPass_(const FrameInput& input) const
         input.framebufferSize.h,
         input.simFrozen,
         input.simSpeed,
+        input.achievedSimSpeed,
         input.simElapsed,
         input.fps,
         *overlayInput.menu,
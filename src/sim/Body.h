@@ -2,7 +2,7 @@
 #define PHYSICS3D_BODY_H
 
 #include <cstdint>
-#include <string>
+#include "Material.h"
 #include "Quaternion.h"
 #include "Vec3.h"
 
@@ -15,19 +15,16 @@ namespace sim {
         Vec3 velocity; // [m/s]
         Vec3 angularVelocity; // [rad/s]
         Vec3 torque; // [N*m] accumulated external torque for this step
-        double invMass{}; // [1/kg]  (0 means "infinite mass" / static body)
-        double invInertia{0.0}; // [1/(kg*m^2)] if <=0, sphere inertia is derived from mass/radius
-        double radius{1.0}; // [m]
-        double restitution{0.5}; // [0..1] cached from the assigned material
-        double staticFriction{0.6}; // cached from the assigned material
-        double dynamicFriction{0.4}; // cached from the assigned material
-        std::string materialName{"DEFAULT"}; // Material id/name used at assignment/load time
+        Real invMass{}; // [1/kg]  (0 means "infinite mass" / static body)
+        Real invInertia{0.0}; // [1/(kg*m^2)] if <=0, sphere inertia is derived from mass/radius
+        Real radius{1.0}; // [m]
+        MaterialHandle material = kDefaultMaterial; // Registry handle; see Material.h
         Quaternion orientation; // world orientation
         Quaternion prevOrientation; // previous world orientation for render interpolation
         Vec3 prevPosition; // previous world position for render interpolation
         std::uint64_t id = 0; // Stable identity assigned by World
         bool sleeping = false;
-        double sleepTimer = 0.0;
+        Real sleepTimer = 0.0;
     };
 } // sim
 
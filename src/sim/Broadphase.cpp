@@ -5,24 +5,54 @@
 namespace sim::broadphase {
     namespace {
         [[nodiscard]] bool canBodiesGeneratePair(const Body& a, const Body& b) {
-            return a.invMass > 0.0 || b.invMass > 0.0;
+            return a.invMass > Real(0.0) || b.invMass > Real(0.0);
         }
 
-        struct AxisInterval {
-            std::size_t idx = 0;
-            double minX = 0.0;
-            double maxX = 0.0;
-            double minY = 0.0;
-            double maxY = 0.0;
-            double minZ = 0.0;
-            double maxZ = 0.0;
-        };
-
         [[nodiscard]] bool overlapsYZ(const AxisInterval& a, const AxisInterval& b) {
             return a.maxY >= b.minY && b.maxY >= a.minY &&
                    a.maxZ >= b.minZ && b.maxZ >= a.minZ;
         }
 
+        [[nodiscard]] bool overlapsX(const AxisInterval& a, const AxisInterval& b) {
+            return a.maxX >= b.minX && b.maxX >= a.minX;
+        }
+
+        // Ties go by body index, so the order (and with it the pair order) is a function of the
+        // bodies alone, not of how a particular std::sort happens to shuffle equal keys.
+        [[nodiscard]] bool minXBefore(const AxisInterval& a, const AxisInterval& b) {
+            return a.minX < b.minX || (a.minX == b.minX && a.idx < b.idx);
+        }
+
+        template <typename Intervals>
+        void sortByMinX(Intervals& intervals)
+        {
+            std::ranges::sort(intervals, minXBefore);
+        }
+
+        template <typename Intervals, typename Pairs>
+        void sweepSorted(
+            const std::vector<Body>& bodies,
+            const Intervals& intervals,
+            Pairs& outPairs)
+        {
+            if (intervals.size() < 2) {
+                return;
+            }
+
+            for (std::size_t i = 0; i + 1 < intervals.size(); ++i) {
+                const AxisInterval& a = intervals[i];
+                for (std::size_t j = i + 1; j < intervals.size(); ++j) {
+                    const AxisInterval& b = intervals[j];
+                    if (b.minX > a.maxX) {
+                        break;
+                    }
+                    if (overlapsYZ(a, b) && canBodiesGeneratePair(bodies[a.idx], bodies[b.idx])) {
+                        outPairs.emplace_back(std::min(a.idx, b.idx), std::max(a.idx, b.idx));
+                    }
+                }
+            }
+        }
+
         template <typename Builder>
         void sapPairs(const std::vector<Body>& bodies, Builder&& builder, std::vector<Pair>& outPairs)
         {
@@ -31,8 +61,7 @@ namespace sim::broadphase {
                 return;
             }
 
-            thread_local std::vector<AxisInterval> intervals;
-            intervals.clear();
+            std::vector<AxisInterval> intervals;
             intervals.reserve(bodies.size());
             outPairs.reserve(std::max(outPairs.capacity(), bodies.size() * 2));
 
@@ -42,33 +71,45 @@ namespace sim::broadphase {
                     intervals.push_back(in);
                 }
             }
+            sortByMinX(intervals);
+            sweepSorted(bodies, intervals, outPairs);
+        }
 
-            if (intervals.size() < 2) {
-                return;
+        // Moving bodies are swept against each other, then each one queries the inert set.
+        template <typename Builder>
+        void sapPairs(
+            const std::vector<Body>& bodies,
+            const std::span<const std::size_t> moving,
+            const InertSet& inert,
+            Builder&& builder,
+            Scratch& scratch,
+            PairList& outPairs)
+        {
+            outPairs.clear();
+            auto& intervals = scratch.intervals;
+            intervals.clear();
+            intervals.reserve(moving.size());
+            for (const std::size_t i : moving) {
+                AxisInterval in;
+                if (builder(bodies[i], i, in)) {
+                    intervals.push_back(in);
+                }
             }
-
-            std::ranges::sort(intervals, [](const AxisInterval& a, const AxisInterval& b) {
-                return a.minX < b.minX;
-            });
-
-            for (std::size_t i = 0; i + 1 < intervals.size(); ++i) {
-                const AxisInterval& a = intervals[i];
-                for (std::size_t j = i + 1; j < intervals.size(); ++j) {
-                    const AxisInterval& b = intervals[j];
-                    if (b.minX > a.maxX) {
-                        break;
-                    }
-                    if (overlapsYZ(a, b) && canBodiesGeneratePair(bodies[a.idx], bodies[b.idx])) {
-                        outPairs.emplace_back(std::min(a.idx, b.idx), std::max(a.idx, b.idx));
-                    }
+            sortByMinX(intervals);
+            // Contacts with inert bodies (usually the supporting ones) come first, as they would
+            // for a ground body in a full sweep; solve order matters to Gauss-Seidel.
+            if (inert.size() != 0) {
+                for (const AxisInterval& in : intervals) {
+                    inert.appendOverlaps(bodies, in, outPairs);
                 }
             }
+            sweepSorted(bodies, intervals, outPairs);
         }
 
         [[nodiscard]] bool buildDiscreteInterval(const Body& b, const std::size_t index, AxisInterval& out)
         {
             if (!std::isfinite(b.position.x) || !std::isfinite(b.position.y) || !std::isfinite(b.position.z) ||
-                !std::isfinite(b.radius) || b.radius < 0.0) {
+                !std::isfinite(b.radius) || b.radius < Real(0.0)) {
                 return false;
             }
 
@@ -87,16 +128,16 @@ namespace sim::broadphase {
         [[nodiscard]] bool buildSweptInterval(
             const Body& b,
             const std::size_t index,
-            const double maxTime,
+            const Real maxTime,
             AxisInterval& out)
         {
             if (!std::isfinite(b.position.x) || !std::isfinite(b.position.y) || !std::isfinite(b.position.z) ||
                 !std::isfinite(b.velocity.x) || !std::isfinite(b.velocity.y) || !std::isfinite(b.velocity.z) ||
-                !std::isfinite(b.radius) || b.radius < 0.0) {
+                !std::isfinite(b.radius) || b.radius < Real(0.0)) {
                 return false;
             }
 
-            const Vec3 endPos = b.position + b.velocity * std::max(0.0, maxTime);
+            const Vec3 endPos = b.position + b.velocity * std::max<Real>(0.0, maxTime);
             if (!std::isfinite(endPos.x) || !std::isfinite(endPos.y) || !std::isfinite(endPos.z)) {
                 return false;
             }
@@ -114,6 +155,78 @@ namespace sim::broadphase {
         }
     } // namespace
 
+    Scratch::Scratch(std::pmr::memory_resource* memory)
+        : intervals(memory), widths(memory) {}
+
+    void InertSet::build(const std::vector<Body>& bodies, const std::span<const std::size_t> indices, Scratch& scratch)
+    {
+        clear();
+        for (const std::size_t i : indices) {
+            AxisInterval in;
+            if (buildDiscreteInterval(bodies[i], i, in)) {
+                sorted_.push_back(in);
+            }
+        }
+        if (sorted_.empty()) {
+            return;
+        }
+
+        // "Wide" means far above the median width; those few are tested against every query.
+        auto& widths = scratch.widths;
+        widths.clear();
+        for (const AxisInterval& in : sorted_) {
+            widths.push_back(in.maxX - in.minX);
+        }
+        const auto median = widths.begin() + static_cast<std::ptrdiff_t>(widths.size() / 2);
+        std::ranges::nth_element(widths, median);
+        const Real wideThreshold = Real(8.0) * *median;
+
+        const auto wideBegin = std::stable_partition(sorted_.begin(), sorted_.end(), [&](const AxisInterval& in) {
+            return in.maxX - in.minX <= wideThreshold;
+        });
+        wide_.assign(wideBegin, sorted_.end());
+        sorted_.erase(wideBegin, sorted_.end());
+        sortByMinX(sorted_);
+        for (const AxisInterval& in : sorted_) {
+            maxSortedWidthX_ = std::max(maxSortedWidthX_, in.maxX - in.minX);
+        }
+    }
+
+    void InertSet::clear()
+    {
+        sorted_.clear();
+        wide_.clear();
+        maxSortedWidthX_ = 0.0;
+    }
+
+    std::size_t InertSet::size() const
+    {
+        return sorted_.size() + wide_.size();
+    }
+
+    void InertSet::appendOverlaps(
+        const std::vector<Body>& bodies,
+        const AxisInterval& moving,
+        PairList& outPairs) const
+    {
+        const auto emit = [&](const AxisInterval& in) {
+            if (overlapsX(moving, in) && overlapsYZ(moving, in) &&
+                canBodiesGeneratePair(bodies[moving.idx], bodies[in.idx])) {
+                outPairs.emplace_back(std::min(moving.idx, in.idx), std::max(moving.idx, in.idx));
+            }
+        };
+
+        // Any overlapping interval starts no earlier than moving.minX minus the widest sorted one.
+        const Real firstMinX = moving.minX - maxSortedWidthX_;
+        auto it = std::ranges::lower_bound(sorted_, firstMinX, {}, &AxisInterval::minX);
+        for (; it != sorted_.end() && it->minX <= moving.maxX; ++it) {
+            emit(*it);
+        }
+        for (const AxisInterval& in : wide_) {
+            emit(in);
+        }
+    }
+
     void discretePairs(const std::vector<Body>& bodies, std::vector<Pair>& outPairs)
     {
         sapPairs(bodies, buildDiscreteInterval, outPairs);
@@ -126,17 +239,40 @@ namespace sim::broadphase {
         return pairs;
     }
 
-    void sweptPairs(const std::vector<Body>& bodies, const double maxTime, std::vector<Pair>& outPairs)
+    void sweptPairs(const std::vector<Body>& bodies, const Real maxTime, std::vector<Pair>& outPairs)
     {
         sapPairs(bodies, [maxTime](const Body& b, const std::size_t index, AxisInterval& out) {
             return buildSweptInterval(b, index, maxTime, out);
         }, outPairs);
     }
 
-    std::vector<Pair> sweptPairs(const std::vector<Body>& bodies, const double maxTime)
+    std::vector<Pair> sweptPairs(const std::vector<Body>& bodies, const Real maxTime)
     {
         std::vector<Pair> pairs;
         sweptPairs(bodies, maxTime, pairs);
         return pairs;
     }
+
+    void discretePairs(
+        const std::vector<Body>& bodies,
+        const std::span<const std::size_t> moving,
+        const InertSet& inert,
+        Scratch& scratch,
+        PairList& outPairs)
+    {
+        sapPairs(bodies, moving, inert, buildDiscreteInterval, scratch, outPairs);
+    }
+
+    void sweptPairs(
+        const std::vector<Body>& bodies,
+        const std::span<const std::size_t> moving,
+        const InertSet& inert,
+        const Real maxTime,
+        Scratch& scratch,
+        PairList& outPairs)
+    {
+        sapPairs(bodies, moving, inert, [maxTime](const Body& b, const std::size_t index, AxisInterval& out) {
+            return buildSweptInterval(b, index, maxTime, out);
+        }, scratch, outPairs);
+    }
 } // namespace sim::broadphase
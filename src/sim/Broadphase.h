@@ -2,17 +2,73 @@
 #define PHYSICS3D_BROADPHASE_H
 
 #include <cstddef>
+#include <memory_resource>
+#include <span>
 #include <utility>
 #include <vector>
 #include "Body.h"
 
 namespace sim::broadphase {
     using Pair = std::pair<std::size_t, std::size_t>;
+    using PairList = std::pmr::vector<Pair>;
+
+    struct AxisInterval {
+        std::size_t idx = 0;
+        Real minX = 0.0;
+        Real maxX = 0.0;
+        Real minY = 0.0;
+        Real maxY = 0.0;
+        Real minZ = 0.0;
+        Real maxZ = 0.0;
+    };
+
+    // Working memory the moving-versus-inert queries reuse from call to call. World keeps one on
+    // its frame arena.
+    struct Scratch {
+        explicit Scratch(std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+        std::pmr::vector<AxisInterval> intervals;
+        std::pmr::vector<Real> widths;
+    };
+
+    // Bounds of bodies that do not move (static bodies at rest, sleeping bodies), sorted once and
+    // reused by every query until the set changes. Intervals much wider than typical are kept in
+    // a separate list so one huge ground body does not widen every sorted-range query.
+    class InertSet {
+    public:
+        void build(const std::vector<Body>& bodies, std::span<const std::size_t> indices, Scratch& scratch);
+        void clear();
+        [[nodiscard]] std::size_t size() const;
+
+        // Appends a pair for every inert body whose bounds overlap `moving`.
+        void appendOverlaps(const std::vector<Body>& bodies, const AxisInterval& moving, PairList& outPairs) const;
+
+    private:
+        std::vector<AxisInterval> sorted_{};
+        std::vector<AxisInterval> wide_{};
+        Real maxSortedWidthX_ = 0.0;
+    };
 
     void discretePairs(const std::vector<Body>& bodies, std::vector<Pair>& outPairs);
     [[nodiscard]] std::vector<Pair> discretePairs(const std::vector<Body>& bodies);
-    void sweptPairs(const std::vector<Body>& bodies, double maxTime, std::vector<Pair>& outPairs);
-    [[nodiscard]] std::vector<Pair> sweptPairs(const std::vector<Body>& bodies, double maxTime);
+    void sweptPairs(const std::vector<Body>& bodies, Real maxTime, std::vector<Pair>& outPairs);
+    [[nodiscard]] std::vector<Pair> sweptPairs(const std::vector<Body>& bodies, Real maxTime);
+
+    // Same queries restricted to pairs with at least one body in `moving`; pairs between two
+    // inert bodies are never reported. Inert bodies are treated as having zero velocity.
+    void discretePairs(
+        const std::vector<Body>& bodies,
+        std::span<const std::size_t> moving,
+        const InertSet& inert,
+        Scratch& scratch,
+        PairList& outPairs);
+    void sweptPairs(
+        const std::vector<Body>& bodies,
+        std::span<const std::size_t> moving,
+        const InertSet& inert,
+        Real maxTime,
+        Scratch& scratch,
+        PairList& outPairs);
 } // namespace sim::broadphase
 
 #endif // PHYSICS3D_BROADPHASE_H
@@ -4,21 +4,8 @@
 
 namespace sim::collision {
     namespace {
-        constexpr double kRestitutionVelocityThreshold = 1e-3;
-
-        [[nodiscard]] double epsilon(const Body& a, const Body& b) {
-            return std::max((a.radius + b.radius) * 1e-6, 1e-12);
-        }
-
-        [[nodiscard]] double invInertiaSphere(const Body& b) {
-            if (std::isfinite(b.invInertia) && b.invInertia > 0.0) {
-                return b.invInertia;
-            }
-            if (!std::isfinite(b.invMass) || b.invMass <= 0.0 || !std::isfinite(b.radius) || b.radius <= 0.0) {
-                return 0.0;
-            }
-            // Solid sphere: I = 2/5 m r^2 => invI = 5/2 * invMass / r^2
-            return 2.5 * b.invMass / (b.radius * b.radius);
+        [[nodiscard]] Real epsilon(const Body& a, const Body& b) {
+            return std::max((a.radius + b.radius) * Real(1e-6), Real(1e-12));
         }
 
         [[nodiscard]] Vec3 contactOffsetA(const Body& a, const Vec3& normal) {
@@ -35,18 +22,18 @@ namespace sim::collision {
             return vBContact - vAContact;
         }
 
-        [[nodiscard]] double rotationalContribution(const double invInertia, const Vec3& r, const Vec3& dir)
+        [[nodiscard]] Real rotationalContribution(const Real invInertia, const Vec3& r, const Vec3& dir)
         {
-            if (invInertia <= 0.0) {
+            if (invInertia <= Real(0.0)) {
                 return 0.0;
             }
             const Vec3 rCrossDir = r.cross(dir);
             return invInertia * rCrossDir.dot(rCrossDir);
         }
 
-        [[nodiscard]] double effectiveMassAlong(
+        [[nodiscard]] Real effectiveMassAlong(
             const Body& a, const Body& b,
-            const double invIA, const double invIB,
+            const Real invIA, const Real invIB,
             const Vec3& rA, const Vec3& rB, const Vec3& dir)
         {
             return a.invMass + b.invMass +
@@ -57,8 +44,8 @@ namespace sim::collision {
         void applyImpulseAtContact(
             Body& a,
             Body& b,
-            const double invIA,
-            const double invIB,
+            const Real invIA,
+            const Real invIB,
             const Vec3& rA,
             const Vec3& rB,
             const Vec3& impulse)
@@ -67,42 +54,58 @@ namespace sim::collision {
                 return;
             }
 
-            const double wA = a.invMass;
-            const double wB = b.invMass;
-            if (!std::isfinite(wA) || !std::isfinite(wB) || (wA == 0.0 && wB == 0.0)) {
+            const Real wA = a.invMass;
+            const Real wB = b.invMass;
+            if (!std::isfinite(wA) || !std::isfinite(wB) || (wA == Real(0.0) && wB == Real(0.0))) {
                 return;
             }
 
-            a.velocity -= impulse * wA;
-            b.velocity += impulse * wB;
-
-            if (invIA > 0.0) {
-                a.angularVelocity -= (rA.cross(impulse)) * invIA;
+            // Static bodies are never written, so islands that share one can be solved concurrently.
+            if (wA > Real(0.0)) {
+                a.velocity -= impulse * wA;
+                if (invIA > Real(0.0)) {
+                    a.angularVelocity -= (rA.cross(impulse)) * invIA;
+                }
             }
-            if (invIB > 0.0) {
-                b.angularVelocity += (rB.cross(impulse)) * invIB;
+            if (wB > Real(0.0)) {
+                b.velocity += impulse * wB;
+                if (invIB > Real(0.0)) {
+                    b.angularVelocity += (rB.cross(impulse)) * invIB;
+                }
             }
         }
     } // namespace
 
+    Real invInertiaSphere(const Body& b)
+    {
+        if (std::isfinite(b.invInertia) && b.invInertia > Real(0.0)) {
+            return b.invInertia;
+        }
+        if (!std::isfinite(b.invMass) || b.invMass <= Real(0.0) || !std::isfinite(b.radius) || b.radius <= Real(0.0)) {
+            return 0.0;
+        }
+        // Solid sphere: I = 2/5 m r^2 => invI = 5/2 * invMass / r^2
+        return Real(2.5) * b.invMass / (b.radius * b.radius);
+    }
+
     bool isColliding(const Body& a, const Body& b)
     {
         const Vec3 d = b.position - a.position;
-        const double minDistance = a.radius + b.radius;
-        const double r2 = d.dot(d);
+        const Real minDistance = a.radius + b.radius;
+        const Real r2 = d.dot(d);
         return r2 <= minDistance * minDistance;
     }
 
     bool contactNormal(const Body& a, const Body& b, Vec3& outNormal)
     {
         const Vec3 d = b.position - a.position;
-        const double dist2 = d.dot(d);
-        if (!std::isfinite(dist2) || dist2 < 0.0) {
+        const Real dist2 = d.dot(d);
+        if (!std::isfinite(dist2) || dist2 < Real(0.0)) {
             return false;
         }
 
-        const double dist = std::sqrt(dist2);
-        const double eps = epsilon(a, b);
+        const Real dist = std::sqrt(dist2);
+        const Real eps = epsilon(a, b);
         if (dist < eps) {
             outNormal = Vec3(1.0, 0.0, 0.0);
             return true;
@@ -112,45 +115,45 @@ namespace sim::collision {
         return std::isfinite(outNormal.x) && std::isfinite(outNormal.y) && std::isfinite(outNormal.z);
     }
 
-    bool sweptCollisionTime(const Body& a, const Body& b, const double maxTime, double& outTime)
+    bool sweptCollisionTime(const Body& a, const Body& b, const Real maxTime, Real& outTime)
     {
         const Vec3 p = b.position - a.position;
         const Vec3 v = b.velocity - a.velocity;
-        const double r = a.radius + b.radius;
+        const Real r = a.radius + b.radius;
 
         if (!std::isfinite(p.x) || !std::isfinite(p.y) || !std::isfinite(p.z) ||
             !std::isfinite(v.x) || !std::isfinite(v.y) || !std::isfinite(v.z) ||
-            !std::isfinite(r) || r < 0.0 || !std::isfinite(maxTime) || maxTime < 0.0) {
+            !std::isfinite(r) || r < Real(0.0) || !std::isfinite(maxTime) || maxTime < Real(0.0)) {
             return false;
         }
 
-        const double c = p.dot(p) - r * r;
-        if (c <= 0.0) {
+        const Real c = p.dot(p) - r * r;
+        if (c <= Real(0.0)) {
             outTime = 0.0;
             return true;
         }
 
-        const double aCoef = v.dot(v);
-        if (aCoef <= 1e-14 || !std::isfinite(aCoef)) {
+        const Real aCoef = v.dot(v);
+        if (aCoef <= Real(1e-14) || !std::isfinite(aCoef)) {
             return false;
         }
 
-        const double bCoef = 2.0 * p.dot(v);
-        const double disc = bCoef * bCoef - 4.0 * aCoef * c;
-        if (disc < 0.0 || !std::isfinite(disc)) {
+        const Real bCoef = Real(2.0) * p.dot(v);
+        const Real disc = bCoef * bCoef - Real(4.0) * aCoef * c;
+        if (disc < Real(0.0) || !std::isfinite(disc)) {
             return false;
         }
 
-        const double sqrtDisc = std::sqrt(disc);
-        const double invDenom = 0.5 / aCoef;
-        const double t0 = (-bCoef - sqrtDisc) * invDenom;
-        const double t1 = (-bCoef + sqrtDisc) * invDenom;
+        const Real sqrtDisc = std::sqrt(disc);
+        const Real invDenom = Real(0.5) / aCoef;
+        const Real t0 = (-bCoef - sqrtDisc) * invDenom;
+        const Real t1 = (-bCoef + sqrtDisc) * invDenom;
 
-        if (t1 < 0.0) {
+        if (t1 < Real(0.0)) {
             return false;
         }
 
-        const double tHit = (t0 >= 0.0) ? t0 : 0.0;
+        const Real tHit = (t0 >= Real(0.0)) ? t0 : Real(0.0);
         if (tHit > maxTime) {
             return false;
         }
@@ -159,10 +162,10 @@ namespace sim::collision {
         return true;
     }
 
-    void applyNormalImpulse(Body& a, Body& b, const Vec3& normal, const double impulse)
+    void applyNormalImpulse(Body& a, Body& b, const Vec3& normal, const Real impulse)
     {
         if (!std::isfinite(normal.x) || !std::isfinite(normal.y) || !std::isfinite(normal.z) ||
-            !std::isfinite(impulse) || impulse <= 0.0) {
+            !std::isfinite(impulse) || impulse <= Real(0.0)) {
             return;
         }
 
@@ -171,10 +174,10 @@ namespace sim::collision {
         applyImpulseAtContact(a, b, invInertiaSphere(a), invInertiaSphere(b), rA, rB, normal * impulse);
     }
 
-    void applyTangentImpulse(Body& a, Body& b, const Vec3& normal, const Vec3& tangent, const double impulse)
+    void applyTangentImpulse(Body& a, Body& b, const Vec3& normal, const Vec3& tangent, const Real impulse)
     {
         if (!std::isfinite(tangent.x) || !std::isfinite(tangent.y) || !std::isfinite(tangent.z) ||
-            !std::isfinite(impulse) || impulse == 0.0) {
+            !std::isfinite(impulse) || impulse == Real(0.0)) {
             return;
         }
         const Vec3 rA = contactOffsetA(a, normal);
@@ -191,9 +194,9 @@ namespace sim::collision {
             return stats;
         }
 
-        const double wA = a.invMass;
-        const double wB = b.invMass;
-        if (!std::isfinite(wA) || !std::isfinite(wB) || (wA == 0.0 && wB == 0.0)) {
+        const Real wA = a.invMass;
+        const Real wB = b.invMass;
+        if (!std::isfinite(wA) || !std::isfinite(wB) || (wA == Real(0.0) && wB == Real(0.0))) {
             return stats;
         }
 
@@ -201,19 +204,19 @@ namespace sim::collision {
         Vec3& pB = b.position;
 
         const Vec3 d = pB - pA;
-        const double dist2 = d.dot(d);
-        if (!std::isfinite(dist2) || dist2 < 0.0) {
+        const Real dist2 = d.dot(d);
+        if (!std::isfinite(dist2) || dist2 < Real(0.0)) {
             return stats;
         }
-        const double dist = std::sqrt(dist2);
+        const Real dist = std::sqrt(dist2);
 
-        const double pen = (a.radius + b.radius) - dist;
+        const Real pen = (a.radius + b.radius) - dist;
         if (!std::isfinite(pen)) {
             return stats;
         }
 
         Vec3 n = Vec3(1.0, 0.0, 0.0);
-        const double eps = epsilon(a, b);
+        const Real eps = epsilon(a, b);
         if (dist >= eps) {
             n = d / dist;
         }
@@ -223,38 +226,42 @@ namespace sim::collision {
         stats.normal = n;
         stats.hasNormal = true;
 
-        const double invIA = invInertiaSphere(a);
-        const double invIB = invInertiaSphere(b);
+        const Real invIA = invInertiaSphere(a);
+        const Real invIB = invInertiaSphere(b);
         const Vec3 rA = contactOffsetA(a, n);
         const Vec3 rB = contactOffsetB(b, n);
 
-        const double effMassN = effectiveMassAlong(a, b, invIA, invIB, rA, rB, n);
-        if (!std::isfinite(effMassN) || effMassN <= 0.0) {
+        const Real effMassN = effectiveMassAlong(a, b, invIA, invIB, rA, rB, n);
+        if (!std::isfinite(effMassN) || effMassN <= Real(0.0)) {
             return stats;
         }
 
-        const double invMassSum = wA + wB;
-        if (!std::isfinite(invMassSum) || invMassSum <= 0.0) {
+        const Real invMassSum = wA + wB;
+        if (!std::isfinite(invMassSum) || invMassSum <= Real(0.0)) {
             return stats;
         }
 
         if (params.applyPositionCorrection) {
-            const double correction =
-                std::max(0.0, pen - params.penetrationSlop) * params.positionCorrectionPercent;
-            pA -= n * (correction * wA / invMassSum);
-            pB += n * (correction * wB / invMassSum);
+            const Real correction =
+                std::max<Real>(0.0, pen - params.penetrationSlop) * params.positionCorrectionPercent;
+            if (wA > Real(0.0)) {
+                pA -= n * (correction * wA / invMassSum);
+            }
+            if (wB > Real(0.0)) {
+                pB += n * (correction * wB / invMassSum);
+            }
         }
 
         const Vec3 rv = contactRelativeVelocity(a, b, rA, rB);
-        const double vN = rv.dot(n);
-        if (!params.applyVelocityImpulse || vN >= 0.0) {
+        const Real vN = rv.dot(n);
+        if (!params.applyVelocityImpulse || vN >= Real(0.0)) {
             return stats;
         }
 
-        const double restitution =
-            std::abs(vN) > kRestitutionVelocityThreshold ? std::clamp(params.restitution, 0.0, 1.0) : 0.0;
-        const double normalImpulse = std::max(0.0, -((1.0 + restitution) * vN) / effMassN);
-        if (!std::isfinite(normalImpulse) || normalImpulse <= 0.0) {
+        const Real restitution =
+            std::abs(vN) > kRestitutionVelocityThreshold ? std::clamp<Real>(params.restitution, 0.0, 1.0) : Real(0.0);
+        const Real normalImpulse = std::max<Real>(0.0, -((Real(1.0) + restitution) * vN) / effMassN);
+        if (!std::isfinite(normalImpulse) || normalImpulse <= Real(0.0)) {
             return stats;
         }
         applyImpulseAtContact(a, b, invIA, invIB, rA, rB, n * normalImpulse);
@@ -264,30 +271,30 @@ namespace sim::collision {
         // Coulomb friction: solve tangent impulse after normal impulse update.
         const Vec3 rv2 = contactRelativeVelocity(a, b, rA, rB);
         const Vec3 tangentUnscaled = rv2 - n * rv2.dot(n);
-        const double tangentLen2 = tangentUnscaled.dot(tangentUnscaled);
-        if (params.applyFrictionImpulse && tangentLen2 > 1e-24) {
-            const double tangentLen = std::sqrt(tangentLen2);
+        const Real tangentLen2 = tangentUnscaled.dot(tangentUnscaled);
+        if (params.applyFrictionImpulse && tangentLen2 > Real(1e-24)) {
+            const Real tangentLen = std::sqrt(tangentLen2);
             const Vec3 t = tangentUnscaled / tangentLen;
-            const double effMassT = effectiveMassAlong(a, b, invIA, invIB, rA, rB, t);
-            if (effMassT <= 0.0 || !std::isfinite(effMassT)) {
+            const Real effMassT = effectiveMassAlong(a, b, invIA, invIB, rA, rB, t);
+            if (effMassT <= Real(0.0) || !std::isfinite(effMassT)) {
                 return stats;
             }
-            const double jt = -rv2.dot(t) / effMassT;
+            const Real jt = -rv2.dot(t) / effMassT;
             if (!std::isfinite(jt)) {
                 return stats;
             }
 
-            double tangentImpulse = 0.0;
-            const double maxStatic = normalImpulse * std::max(0.0, params.staticFriction);
+            Real tangentImpulse = 0.0;
+            const Real maxStatic = normalImpulse * std::max<Real>(0.0, params.staticFriction);
             if (std::abs(jt) <= maxStatic) {
                 tangentImpulse = jt;
             } else {
-                tangentImpulse = -normalImpulse * std::max(0.0, params.dynamicFriction) * std::copysign(1.0, jt);
+                tangentImpulse = -normalImpulse * std::max<Real>(0.0, params.dynamicFriction) * std::copysign(Real(1.0), jt);
             }
 
             applyImpulseAtContact(a, b, invIA, invIB, rA, rB, t * tangentImpulse);
             stats.tangentImpulse = tangentImpulse;
-            if (tangentImpulse != 0.0) {
+            if (tangentImpulse != Real(0.0)) {
                 stats.impulseApplied = true;
             }
         }
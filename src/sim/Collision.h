@@ -5,12 +5,15 @@
 
 namespace sim::collision {
 
+    // Normal approach speeds below this are treated as resting contact and get no restitution.
+    inline constexpr Real kRestitutionVelocityThreshold = 1e-3;
+
     struct SolveParams {
-        double restitution = 0.5;
-        double staticFriction = 0.6;
-        double dynamicFriction = 0.4;
-        double penetrationSlop = 1e-4;
-        double positionCorrectionPercent = 0.8;
+        Real restitution = 0.5;
+        Real staticFriction = 0.6;
+        Real dynamicFriction = 0.4;
+        Real penetrationSlop = 1e-4;
+        Real positionCorrectionPercent = 0.8;
         bool applyPositionCorrection = true;
         bool applyVelocityImpulse = true;
         bool applyFrictionImpulse = true;
@@ -21,15 +24,16 @@ namespace sim::collision {
         bool impulseApplied = false;
         bool hasNormal = false;
         Vec3 normal{};
-        double normalImpulse = 0.0;
-        double tangentImpulse = 0.0;
+        Real normalImpulse = 0.0;
+        Real tangentImpulse = 0.0;
     };
 
+    [[nodiscard]] Real invInertiaSphere(const Body& b);
     [[nodiscard]] bool isColliding(const Body& a, const Body& b);
     [[nodiscard]] bool contactNormal(const Body& a, const Body& b, Vec3& outNormal);
-    [[nodiscard]] bool sweptCollisionTime(const Body& a, const Body& b, double maxTime, double& outTime);
-    void applyNormalImpulse(Body& a, Body& b, const Vec3& normal, double impulse);
-    void applyTangentImpulse(Body& a, Body& b, const Vec3& normal, const Vec3& tangent, double impulse);
+    [[nodiscard]] bool sweptCollisionTime(const Body& a, const Body& b, Real maxTime, Real& outTime);
+    void applyNormalImpulse(Body& a, Body& b, const Vec3& normal, Real impulse);
+    void applyTangentImpulse(Body& a, Body& b, const Vec3& normal, const Vec3& tangent, Real impulse);
     SolveStats solveCollisionPair(Body& a, Body& b, const SolveParams& params, bool assumeColliding);
 
 } // namespace sim::collision
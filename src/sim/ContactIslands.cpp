@@ -0,0 +1,179 @@
+#include "ContactIslands.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace sim::islands {
+    namespace {
+        constexpr std::size_t kNoIsland = std::numeric_limits<std::size_t>::max();
+
+        [[nodiscard]] bool linksIsland(const Body& b) {
+            return std::isfinite(b.invMass) && b.invMass > Real(0.0);
+        }
+    } // namespace
+
+    void DisjointSet::reset(const std::size_t count)
+    {
+        parent_.resize(count);
+        size_.assign(count, 1);
+        for (std::size_t i = 0; i < count; ++i) {
+            parent_[i] = i;
+        }
+    }
+
+    std::size_t DisjointSet::find(std::size_t i)
+    {
+        while (parent_[i] != i) {
+            parent_[i] = parent_[parent_[i]];
+            i = parent_[i];
+        }
+        return i;
+    }
+
+    void DisjointSet::unite(const std::size_t a, const std::size_t b)
+    {
+        std::size_t rootA = find(a);
+        std::size_t rootB = find(b);
+        if (rootA == rootB) {
+            return;
+        }
+        if (size_[rootA] < size_[rootB]) {
+            std::swap(rootA, rootB);
+        }
+        parent_[rootB] = rootA;
+        size_[rootA] += size_[rootB];
+    }
+
+    PartitionScratch::PartitionScratch(std::pmr::memory_resource* memory)
+        : bodySlots(memory), bodyMasks(memory), pairBuckets(memory), cursor(memory) {}
+
+    std::size_t IslandPartition::islandCount() const
+    {
+        return islandOffsets.empty() ? 0 : islandOffsets.size() - 1;
+    }
+
+    void buildPairIslands(
+        const std::span<const Body> bodies,
+        const std::span<const PairIndex> pairs,
+        DisjointSet& sets,
+        PartitionScratch& scratch,
+        IslandPartition& out)
+    {
+        out.pairOrder.clear();
+        out.islandOffsets.clear();
+        if (pairs.empty()) {
+            return;
+        }
+
+        sets.reset(bodies.size());
+        for (const auto& [i, j] : pairs) {
+            if (linksIsland(bodies[i]) && linksIsland(bodies[j])) {
+                sets.unite(i, j);
+            }
+        }
+
+        // Island ids are handed out in first-pair order, which keeps the partition deterministic.
+        auto& islandOfRoot = scratch.bodySlots;
+        auto& pairIsland = scratch.pairBuckets;
+        islandOfRoot.assign(bodies.size(), kNoIsland);
+        pairIsland.resize(pairs.size());
+        std::size_t islandCount = 0;
+        for (std::size_t p = 0; p < pairs.size(); ++p) {
+            const auto& [i, j] = pairs[p];
+            const std::size_t anchor = linksIsland(bodies[i]) ? i : j;
+            const std::size_t root = sets.find(anchor);
+            if (islandOfRoot[root] == kNoIsland) {
+                islandOfRoot[root] = islandCount++;
+            }
+            pairIsland[p] = islandOfRoot[root];
+        }
+
+        out.islandOffsets.assign(islandCount + 1, 0);
+        for (std::size_t p = 0; p < pairs.size(); ++p) {
+            ++out.islandOffsets[pairIsland[p] + 1];
+        }
+        for (std::size_t k = 0; k < islandCount; ++k) {
+            out.islandOffsets[k + 1] += out.islandOffsets[k];
+        }
+
+        auto& cursor = scratch.cursor;
+        cursor.assign(out.islandOffsets.begin(), out.islandOffsets.end() - 1);
+        out.pairOrder.resize(pairs.size());
+        for (std::size_t p = 0; p < pairs.size(); ++p) {
+            out.pairOrder[cursor[pairIsland[p]]++] = p;
+        }
+    }
+
+    std::size_t ColorPartition::colorCount() const
+    {
+        return colorOffsets.empty() ? 0 : colorOffsets.size() - 1;
+    }
+
+    void buildPairColors(
+        const std::span<const Body> bodies,
+        const std::span<const PairIndex> pairs,
+        PartitionScratch& scratch,
+        ColorPartition& out)
+    {
+        out.pairOrder.clear();
+        out.colorOffsets.clear();
+        out.overflowColor = false;
+        if (pairs.empty()) {
+            return;
+        }
+
+        constexpr std::size_t kOverflow = ColorPartition::kMaxPairColors;
+        auto& usedColors = scratch.bodyMasks;
+        auto& pairColor = scratch.pairBuckets;
+        usedColors.assign(bodies.size(), 0);
+        pairColor.resize(pairs.size());
+
+        std::size_t colorCount = 0;
+        for (std::size_t p = 0; p < pairs.size(); ++p) {
+            const auto& [i, j] = pairs[p];
+            const bool dynamicI = linksIsland(bodies[i]);
+            const bool dynamicJ = linksIsland(bodies[j]);
+            const std::uint64_t used = (dynamicI ? usedColors[i] : 0) | (dynamicJ ? usedColors[j] : 0);
+            if (used == ~std::uint64_t{0}) {
+                pairColor[p] = kOverflow;
+                out.overflowColor = true;
+                continue;
+            }
+
+            const auto color = static_cast<std::size_t>(std::countr_one(used));
+            const std::uint64_t bit = std::uint64_t{1} << color;
+            if (dynamicI) {
+                usedColors[i] |= bit;
+            }
+            if (dynamicJ) {
+                usedColors[j] |= bit;
+            }
+            pairColor[p] = color;
+            colorCount = std::max(colorCount, color + 1);
+        }
+
+        // The overflow bucket always sorts last, after every regular color.
+        const std::size_t bucketCount = out.overflowColor ? colorCount + 1 : colorCount;
+        const auto bucketOf = [&](const std::size_t p) {
+            return pairColor[p] == kOverflow ? colorCount : pairColor[p];
+        };
+
+        out.colorOffsets.assign(bucketCount + 1, 0);
+        for (std::size_t p = 0; p < pairs.size(); ++p) {
+            ++out.colorOffsets[bucketOf(p) + 1];
+        }
+        for (std::size_t k = 0; k < bucketCount; ++k) {
+            out.colorOffsets[k + 1] += out.colorOffsets[k];
+        }
+
+        auto& cursor = scratch.cursor;
+        cursor.assign(out.colorOffsets.begin(), out.colorOffsets.end() - 1);
+        out.pairOrder.resize(pairs.size());
+        for (std::size_t p = 0; p < pairs.size(); ++p) {
+            out.pairOrder[cursor[bucketOf(p)]++] = p;
+        }
+    }
+} // namespace sim::islands
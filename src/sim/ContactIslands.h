@@ -0,0 +1,76 @@
+#ifndef PHYSICS3D_CONTACTISLANDS_H
+#define PHYSICS3D_CONTACTISLANDS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+#include "Body.h"
+
+namespace sim::islands {
+    using PairIndex = std::pair<std::size_t, std::size_t>;
+
+    class DisjointSet {
+    public:
+        void reset(std::size_t count);
+        [[nodiscard]] std::size_t find(std::size_t i);
+        void unite(std::size_t a, std::size_t b);
+
+    private:
+        std::vector<std::size_t> parent_{};
+        std::vector<std::size_t> size_{};
+    };
+
+    // Working memory for the partition builders. World keeps one on its frame arena.
+    struct PartitionScratch {
+        explicit PartitionScratch(std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+        std::pmr::vector<std::size_t> bodySlots;
+        std::pmr::vector<std::uint64_t> bodyMasks;
+        std::pmr::vector<std::size_t> pairBuckets;
+        std::pmr::vector<std::size_t> cursor;
+    };
+
+    // Pairs grouped so that each island is contiguous in pairOrder; island k spans
+    // [islandOffsets[k], islandOffsets[k + 1]). Islands are ordered by their first pair and keep
+    // the input order internally, so solving them independently reproduces the serial result.
+    struct IslandPartition {
+        std::vector<std::size_t> pairOrder{};
+        std::vector<std::size_t> islandOffsets{};
+
+        [[nodiscard]] std::size_t islandCount() const;
+    };
+
+    // Only dynamic bodies link pairs together; static bodies can be shared by any number of islands.
+    void buildPairIslands(
+        std::span<const Body> bodies,
+        std::span<const PairIndex> pairs,
+        DisjointSet& sets,
+        PartitionScratch& scratch,
+        IslandPartition& out);
+
+    // Pairs grouped into colors: no dynamic body appears twice inside one color, so every color
+    // can be solved in parallel. Color k spans [colorOffsets[k], colorOffsets[k + 1]) of pairOrder.
+    // Pairs that do not fit into kMaxPairColors colors land in a final overflow color that must be
+    // solved serially (overflowColor is true in that case).
+    struct ColorPartition {
+        static constexpr std::size_t kMaxPairColors = 64;
+
+        std::vector<std::size_t> pairOrder{};
+        std::vector<std::size_t> colorOffsets{};
+        bool overflowColor = false;
+
+        [[nodiscard]] std::size_t colorCount() const;
+    };
+
+    // Greedy coloring in input order; static bodies may appear in several pairs of one color.
+    void buildPairColors(
+        std::span<const Body> bodies,
+        std::span<const PairIndex> pairs,
+        PartitionScratch& scratch,
+        ColorPartition& out);
+} // namespace sim::islands
+
+#endif // PHYSICS3D_CONTACTISLANDS_H
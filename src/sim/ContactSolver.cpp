@@ -0,0 +1,838 @@
+#include "ContactSolver.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sim::collision {
+    namespace {
+        [[nodiscard]] bool isFinite(const Vec3& v) {
+            return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z);
+        }
+
+        // Separation speed the accumulated normal row aims for, given the normal velocity before impulses.
+        [[nodiscard]] Real restitutionBias(const Real restitution, const Real approach) {
+            return approach < -kRestitutionVelocityThreshold ? -restitution * approach : Real(0.0);
+        }
+
+        // Split-impulse position row: pushes the pair's pseudo displacement (deltaPosition) apart
+        // until positionTarget is reached. Velocities are never touched, so correcting penetration
+        // adds no kinetic energy.
+        void solvePositionRow(ContactConstraints& constraints, SolverBodies& bodies, const std::size_t k)
+        {
+            if (constraints.active[k] == 0 || constraints.positionTarget[k] <= Real(0.0)) {
+                return;
+            }
+            const std::uint32_t a = constraints.bodyA[k];
+            const std::uint32_t b = constraints.bodyB[k];
+            const Real wA = bodies.invMass[a];
+            const Real wB = bodies.invMass[b];
+            const Vec3 n(constraints.normalX[k], constraints.normalY[k], constraints.normalZ[k]);
+            const Real pushed = (bodies.deltaPosition[b] - bodies.deltaPosition[a]).dot(n);
+            const Real oldImpulse = constraints.positionImpulse[k];
+            const Real newImpulse =
+                std::max<Real>(0.0, oldImpulse + (constraints.positionTarget[k] - pushed) * constraints.normalMass[k]);
+            if (!std::isfinite(newImpulse)) {
+                return;
+            }
+            const Real delta = newImpulse - oldImpulse;
+            if (wA > Real(0.0)) {
+                bodies.deltaPosition[a] -= n * (delta * wA);
+            }
+            if (wB > Real(0.0)) {
+                bodies.deltaPosition[b] += n * (delta * wB);
+            }
+            constraints.positionImpulse[k] = newImpulse;
+        }
+
+        // Lane-major scratch for one group of rows. Every loop below runs over the lanes with no
+        // data-dependent control flow, which is the form compilers turn into packed vector code.
+        // The arithmetic mirrors solveContactVelocities term for term so both paths agree.
+        template <std::size_t Lanes>
+        struct ContactLanes {
+            Real nx[Lanes], ny[Lanes], nz[Lanes];
+            Real rAx[Lanes], rAy[Lanes], rAz[Lanes];
+            Real rBx[Lanes], rBy[Lanes], rBz[Lanes];
+            Real wA[Lanes], wB[Lanes], invIA[Lanes], invIB[Lanes];
+            Real vAx[Lanes], vAy[Lanes], vAz[Lanes];
+            Real vBx[Lanes], vBy[Lanes], vBz[Lanes];
+            Real aAx[Lanes], aAy[Lanes], aAz[Lanes];
+            Real aBx[Lanes], aBy[Lanes], aBz[Lanes];
+            Real normalMass[Lanes], tangentMass[Lanes];
+            Real restitution[Lanes], velocityBias[Lanes], staticFriction[Lanes], dynamicFriction[Lanes];
+            Real normalImpulse[Lanes];
+            Real frictionX[Lanes], frictionY[Lanes], frictionZ[Lanes];
+            bool active[Lanes];
+            bool applied[Lanes];
+
+            void relativeVelocity(const std::size_t l, Real& x, Real& y, Real& z) const
+            {
+                const Real cBx = vBx[l] + (aBy[l] * rBz[l] - aBz[l] * rBy[l]);
+                const Real cBy = vBy[l] + (aBz[l] * rBx[l] - aBx[l] * rBz[l]);
+                const Real cBz = vBz[l] + (aBx[l] * rBy[l] - aBy[l] * rBx[l]);
+                const Real cAx = vAx[l] + (aAy[l] * rAz[l] - aAz[l] * rAy[l]);
+                const Real cAy = vAy[l] + (aAz[l] * rAx[l] - aAx[l] * rAz[l]);
+                const Real cAz = vAz[l] + (aAx[l] * rAy[l] - aAy[l] * rAx[l]);
+                x = cBx - cAx;
+                y = cBy - cAy;
+                z = cBz - cAz;
+            }
+
+            void load(const ContactConstraints& constraints, const SolverBodies& bodies, const std::size_t first)
+            {
+                for (std::size_t l = 0; l < Lanes; ++l) {
+                    const std::size_t k = first + l;
+                    const std::uint32_t a = constraints.bodyA[k];
+                    const std::uint32_t b = constraints.bodyB[k];
+                    active[l] = constraints.active[k] != 0;
+                    nx[l] = constraints.normalX[k];
+                    ny[l] = constraints.normalY[k];
+                    nz[l] = constraints.normalZ[k];
+                    rAx[l] = nx[l] * constraints.offsetA[k];
+                    rAy[l] = ny[l] * constraints.offsetA[k];
+                    rAz[l] = nz[l] * constraints.offsetA[k];
+                    rBx[l] = nx[l] * -constraints.offsetB[k];
+                    rBy[l] = ny[l] * -constraints.offsetB[k];
+                    rBz[l] = nz[l] * -constraints.offsetB[k];
+                    wA[l] = bodies.invMass[a];
+                    wB[l] = bodies.invMass[b];
+                    invIA[l] = bodies.invInertia[a];
+                    invIB[l] = bodies.invInertia[b];
+                    vAx[l] = bodies.velocity[a].x;
+                    vAy[l] = bodies.velocity[a].y;
+                    vAz[l] = bodies.velocity[a].z;
+                    vBx[l] = bodies.velocity[b].x;
+                    vBy[l] = bodies.velocity[b].y;
+                    vBz[l] = bodies.velocity[b].z;
+                    aAx[l] = bodies.angularVelocity[a].x;
+                    aAy[l] = bodies.angularVelocity[a].y;
+                    aAz[l] = bodies.angularVelocity[a].z;
+                    aBx[l] = bodies.angularVelocity[b].x;
+                    aBy[l] = bodies.angularVelocity[b].y;
+                    aBz[l] = bodies.angularVelocity[b].z;
+                    normalMass[l] = constraints.normalMass[k];
+                    tangentMass[l] = constraints.tangentMass[k];
+                    restitution[l] = constraints.restitution[k];
+                    velocityBias[l] = constraints.velocityBias[k];
+                    staticFriction[l] = constraints.staticFriction[k];
+                    dynamicFriction[l] = constraints.dynamicFriction[k];
+                    normalImpulse[l] = constraints.normalImpulse[k];
+                    frictionX[l] = constraints.frictionImpulseX[k];
+                    frictionY[l] = constraints.frictionImpulseY[k];
+                    frictionZ[l] = constraints.frictionImpulseZ[k];
+                }
+            }
+
+            // Static bodies may sit in several lanes; they are read by load but never written back.
+            void storeVelocities(const ContactConstraints& constraints, SolverBodies& bodies, const std::size_t first) const
+            {
+                for (std::size_t l = 0; l < Lanes; ++l) {
+                    const std::size_t k = first + l;
+                    if (wA[l] > Real(0.0)) {
+                        const std::uint32_t a = constraints.bodyA[k];
+                        bodies.velocity[a] = Vec3(vAx[l], vAy[l], vAz[l]);
+                        bodies.angularVelocity[a] = Vec3(aAx[l], aAy[l], aAz[l]);
+                    }
+                    if (wB[l] > Real(0.0)) {
+                        const std::uint32_t b = constraints.bodyB[k];
+                        bodies.velocity[b] = Vec3(vBx[l], vBy[l], vBz[l]);
+                        bodies.angularVelocity[b] = Vec3(aBx[l], aBy[l], aBz[l]);
+                    }
+                }
+            }
+
+            void applyTangentImpulse(const std::size_t l, const Real px, const Real py, const Real pz)
+            {
+                vAx[l] -= px * wA[l];
+                vAy[l] -= py * wA[l];
+                vAz[l] -= pz * wA[l];
+                aAx[l] -= (rAy[l] * pz - rAz[l] * py) * invIA[l];
+                aAy[l] -= (rAz[l] * px - rAx[l] * pz) * invIA[l];
+                aAz[l] -= (rAx[l] * py - rAy[l] * px) * invIA[l];
+                vBx[l] += px * wB[l];
+                vBy[l] += py * wB[l];
+                vBz[l] += pz * wB[l];
+                aBx[l] += (rBy[l] * pz - rBz[l] * py) * invIB[l];
+                aBy[l] += (rBz[l] * px - rBx[l] * pz) * invIB[l];
+                aBz[l] += (rBx[l] * py - rBy[l] * px) * invIB[l];
+            }
+        };
+
+        template <std::size_t Lanes>
+        void solveLaneGroup(ContactConstraints& constraints, SolverBodies& bodies, const std::size_t first)
+        {
+            ContactLanes<Lanes> g;
+            g.load(constraints, bodies, first);
+
+            for (std::size_t l = 0; l < Lanes; ++l) {
+                Real rvx = 0.0;
+                Real rvy = 0.0;
+                Real rvz = 0.0;
+                g.relativeVelocity(l, rvx, rvy, rvz);
+                const Real vN = rvx * g.nx[l] + rvy * g.ny[l] + rvz * g.nz[l];
+                const Real restitution = std::abs(vN) > kRestitutionVelocityThreshold ? g.restitution[l] : Real(0.0);
+                const Real impulse = std::max<Real>(0.0, -(Real(1.0) + restitution) * vN * g.normalMass[l]);
+                const bool applied = g.active[l] && vN < Real(0.0) && std::isfinite(impulse) && impulse > Real(0.0);
+                const Real jn = applied ? impulse : Real(0.0);
+                g.applied[l] = applied;
+                g.normalImpulse[l] = jn;
+                g.vAx[l] -= g.nx[l] * (jn * g.wA[l]);
+                g.vAy[l] -= g.ny[l] * (jn * g.wA[l]);
+                g.vAz[l] -= g.nz[l] * (jn * g.wA[l]);
+                g.vBx[l] += g.nx[l] * (jn * g.wB[l]);
+                g.vBy[l] += g.ny[l] * (jn * g.wB[l]);
+                g.vBz[l] += g.nz[l] * (jn * g.wB[l]);
+            }
+
+            for (std::size_t l = 0; l < Lanes; ++l) {
+                Real rvx = 0.0;
+                Real rvy = 0.0;
+                Real rvz = 0.0;
+                g.relativeVelocity(l, rvx, rvy, rvz);
+                const Real rvN = rvx * g.nx[l] + rvy * g.ny[l] + rvz * g.nz[l];
+                const Real tux = rvx - g.nx[l] * rvN;
+                const Real tuy = rvy - g.ny[l] * rvN;
+                const Real tuz = rvz - g.nz[l] * rvN;
+                const Real tangentLen2 = tux * tux + tuy * tuy + tuz * tuz;
+                const bool sliding = g.applied[l] && tangentLen2 > Real(1e-24);
+                const Real tangentLen = sliding ? std::sqrt(tangentLen2) : Real(1.0);
+                const Real tx = tux / tangentLen;
+                const Real ty = tuy / tangentLen;
+                const Real tz = tuz / tangentLen;
+                const Real jt = -(rvx * tx + rvy * ty + rvz * tz) * g.tangentMass[l];
+                const Real jn = g.normalImpulse[l];
+                const Real maxStatic = jn * g.staticFriction[l];
+                const Real tangentImpulse = std::abs(jt) <= maxStatic
+                    ? jt
+                    : -jn * g.dynamicFriction[l] * std::copysign(Real(1.0), jt);
+                const Real ix = tx * tangentImpulse;
+                const Real iy = ty * tangentImpulse;
+                const Real iz = tz * tangentImpulse;
+                const bool apply = sliding && std::isfinite(jt) &&
+                    std::isfinite(ix) && std::isfinite(iy) && std::isfinite(iz);
+                g.applyTangentImpulse(l, apply ? ix : Real(0.0), apply ? iy : Real(0.0), apply ? iz : Real(0.0));
+            }
+
+            for (std::size_t l = 0; l < Lanes; ++l) {
+                const std::size_t k = first + l;
+                constraints.normalImpulse[k] += g.normalImpulse[l];
+                if (g.applied[l]) {
+                    constraints.impulseApplied[k] = 1;
+                }
+            }
+            g.storeVelocities(constraints, bodies, first);
+        }
+
+        // Lane form of solveAccumulatedContactVelocities; same arithmetic, selects instead of branches.
+        template <std::size_t Lanes>
+        void solveAccumulatedLaneGroup(ContactConstraints& constraints, SolverBodies& bodies, const std::size_t first)
+        {
+            ContactLanes<Lanes> g;
+            g.load(constraints, bodies, first);
+
+            for (std::size_t l = 0; l < Lanes; ++l) {
+                Real rvx = 0.0;
+                Real rvy = 0.0;
+                Real rvz = 0.0;
+                g.relativeVelocity(l, rvx, rvy, rvz);
+                const Real vN = rvx * g.nx[l] + rvy * g.ny[l] + rvz * g.nz[l];
+                const Real lambda = -(vN - g.velocityBias[l]) * g.normalMass[l];
+                const Real oldImpulse = g.normalImpulse[l];
+                const Real newImpulse = std::max<Real>(0.0, oldImpulse + lambda);
+                const bool valid = g.active[l] && std::isfinite(newImpulse);
+                const Real delta = valid ? newImpulse - oldImpulse : Real(0.0);
+                g.normalImpulse[l] = valid ? newImpulse : oldImpulse;
+                g.applied[l] = valid && newImpulse > Real(0.0);
+                g.active[l] = valid;
+                g.vAx[l] -= g.nx[l] * (delta * g.wA[l]);
+                g.vAy[l] -= g.ny[l] * (delta * g.wA[l]);
+                g.vAz[l] -= g.nz[l] * (delta * g.wA[l]);
+                g.vBx[l] += g.nx[l] * (delta * g.wB[l]);
+                g.vBy[l] += g.ny[l] * (delta * g.wB[l]);
+                g.vBz[l] += g.nz[l] * (delta * g.wB[l]);
+            }
+
+            for (std::size_t l = 0; l < Lanes; ++l) {
+                Real rvx = 0.0;
+                Real rvy = 0.0;
+                Real rvz = 0.0;
+                g.relativeVelocity(l, rvx, rvy, rvz);
+                const Real rvN = rvx * g.nx[l] + rvy * g.ny[l] + rvz * g.nz[l];
+                const Real tvx = rvx - g.nx[l] * rvN;
+                const Real tvy = rvy - g.ny[l] * rvN;
+                const Real tvz = rvz - g.nz[l] * rvN;
+                Real fx = g.frictionX[l] - tvx * g.tangentMass[l];
+                Real fy = g.frictionY[l] - tvy * g.tangentMass[l];
+                Real fz = g.frictionZ[l] - tvz * g.tangentMass[l];
+                const Real len2 = fx * fx + fy * fy + fz * fz;
+                const Real maxStatic = g.normalImpulse[l] * g.staticFriction[l];
+                const Real scale = len2 > maxStatic * maxStatic
+                    ? g.normalImpulse[l] * g.dynamicFriction[l] / std::sqrt(len2)
+                    : Real(1.0);
+                fx *= scale;
+                fy *= scale;
+                fz *= scale;
+                const bool apply = g.active[l] && std::isfinite(fx) && std::isfinite(fy) && std::isfinite(fz);
+                const Real px = apply ? fx - g.frictionX[l] : Real(0.0);
+                const Real py = apply ? fy - g.frictionY[l] : Real(0.0);
+                const Real pz = apply ? fz - g.frictionZ[l] : Real(0.0);
+                g.frictionX[l] = apply ? fx : g.frictionX[l];
+                g.frictionY[l] = apply ? fy : g.frictionY[l];
+                g.frictionZ[l] = apply ? fz : g.frictionZ[l];
+                g.applyTangentImpulse(l, px, py, pz);
+            }
+
+            for (std::size_t l = 0; l < Lanes; ++l) {
+                const std::size_t k = first + l;
+                constraints.normalImpulse[k] = g.normalImpulse[l];
+                constraints.frictionImpulseX[k] = g.frictionX[l];
+                constraints.frictionImpulseY[k] = g.frictionY[l];
+                constraints.frictionImpulseZ[k] = g.frictionZ[l];
+                if (g.applied[l]) {
+                    constraints.impulseApplied[k] = 1;
+                }
+            }
+            g.storeVelocities(constraints, bodies, first);
+        }
+
+        template <std::size_t Lanes>
+        void solveLaneGroups(
+            ContactConstraints& constraints,
+            SolverBodies& bodies,
+            const std::size_t begin,
+            const std::size_t end,
+            const ImpulseMode mode,
+            const bool splitImpulse)
+        {
+            std::size_t k = begin;
+            for (; k + Lanes <= end; k += Lanes) {
+                if (mode == ImpulseMode::Accumulated) {
+                    solveAccumulatedLaneGroup<Lanes>(constraints, bodies, k);
+                } else {
+                    solveLaneGroup<Lanes>(constraints, bodies, k);
+                }
+                // Position rows only touch deltaPosition, so they can follow the velocity group.
+                for (std::size_t l = 0; splitImpulse && l < Lanes; ++l) {
+                    solvePositionRow(constraints, bodies, k + l);
+                }
+            }
+            solveContactVelocities(constraints, bodies, k, end, mode, splitImpulse);
+        }
+    } // namespace
+
+    void SolverBodies::clear()
+    {
+        bodyIndex.clear();
+        velocity.clear();
+        angularVelocity.clear();
+        deltaPosition.clear();
+        invMass.clear();
+        invInertia.clear();
+    }
+
+    std::size_t SolverBodies::size() const
+    {
+        return bodyIndex.size();
+    }
+
+    std::uint32_t SolverBodies::add(const Body& body, const std::size_t index)
+    {
+        const bool dynamic = std::isfinite(body.invMass) && body.invMass > Real(0.0);
+        bodyIndex.push_back(index);
+        velocity.push_back(body.velocity);
+        angularVelocity.push_back(body.angularVelocity);
+        deltaPosition.push_back(Vec3{});
+        invMass.push_back(dynamic ? body.invMass : Real(0.0));
+        invInertia.push_back(dynamic ? invInertiaSphere(body) : Real(0.0));
+        return static_cast<std::uint32_t>(bodyIndex.size() - 1);
+    }
+
+    void SolverBodies::scatter(const std::span<Body> bodies) const
+    {
+        for (std::size_t s = 0; s < bodyIndex.size(); ++s) {
+            if (invMass[s] <= Real(0.0)) {
+                continue;
+            }
+            Body& body = bodies[bodyIndex[s]];
+            body.velocity = velocity[s];
+            body.angularVelocity = angularVelocity[s];
+        }
+    }
+
+    void SolverBodies::applyDisplacement(const std::span<Body> bodies) const
+    {
+        for (std::size_t s = 0; s < bodyIndex.size(); ++s) {
+            bodies[bodyIndex[s]].position += deltaPosition[s];
+        }
+    }
+
+    void ContactConstraints::resize(const std::size_t count)
+    {
+        bodyA.resize(count);
+        bodyB.resize(count);
+        normalX.resize(count);
+        normalY.resize(count);
+        normalZ.resize(count);
+        offsetA.resize(count);
+        offsetB.resize(count);
+        separation.resize(count);
+        penetrationSlop.resize(count);
+        positionTarget.resize(count);
+        positionImpulse.resize(count);
+        normalMass.resize(count);
+        tangentMass.resize(count);
+        restitution.resize(count);
+        velocityBias.resize(count);
+        staticFriction.resize(count);
+        dynamicFriction.resize(count);
+        normalImpulse.resize(count);
+        frictionImpulseX.resize(count);
+        frictionImpulseY.resize(count);
+        frictionImpulseZ.resize(count);
+        active.resize(count);
+        impulseApplied.resize(count);
+    }
+
+    std::size_t ContactConstraints::size() const
+    {
+        return bodyA.size();
+    }
+
+    namespace {
+        void prepareRow(
+            ContactConstraints& constraints,
+            const std::size_t k,
+            const Body& a,
+            const Body& b,
+            const std::uint32_t solverA,
+            const std::uint32_t solverB,
+            const SolveParams& params,
+            const bool requireOverlap)
+        {
+            constraints.bodyA[k] = solverA;
+            constraints.bodyB[k] = solverB;
+            constraints.normalImpulse[k] = 0.0;
+            constraints.positionImpulse[k] = 0.0;
+            constraints.positionTarget[k] = 0.0;
+            constraints.frictionImpulseX[k] = 0.0;
+            constraints.frictionImpulseY[k] = 0.0;
+            constraints.frictionImpulseZ[k] = 0.0;
+            constraints.active[k] = 0;
+            constraints.impulseApplied[k] = 0;
+
+            if (requireOverlap && !isColliding(a, b)) {
+                return;
+            }
+
+            const Real wA = std::isfinite(a.invMass) && a.invMass > Real(0.0) ? a.invMass : Real(0.0);
+            const Real wB = std::isfinite(b.invMass) && b.invMass > Real(0.0) ? b.invMass : Real(0.0);
+            const Real invMassSum = wA + wB;
+            if (!std::isfinite(invMassSum) || invMassSum <= Real(0.0)) {
+                return;
+            }
+
+            Vec3 n{};
+            if (!contactNormal(a, b, n)) {
+                return;
+            }
+
+            const Real invIA = wA > Real(0.0) ? invInertiaSphere(a) : Real(0.0);
+            const Real invIB = wB > Real(0.0) ? invInertiaSphere(b) : Real(0.0);
+            // |r x t|^2 == r^2 for any tangent t because the contact offset is parallel to the normal.
+            const Real tangentK = invMassSum + invIA * a.radius * a.radius + invIB * b.radius * b.radius;
+            if (!std::isfinite(tangentK) || tangentK <= Real(0.0)) {
+                return;
+            }
+
+            const Real separation = (b.position - a.position).dot(n) - (a.radius + b.radius);
+            if (!std::isfinite(separation)) {
+                return;
+            }
+
+            constraints.normalX[k] = n.x;
+            constraints.normalY[k] = n.y;
+            constraints.normalZ[k] = n.z;
+            constraints.offsetA[k] = a.radius;
+            constraints.offsetB[k] = b.radius;
+            constraints.separation[k] = separation;
+            constraints.penetrationSlop[k] = std::max<Real>(0.0, params.penetrationSlop);
+            constraints.positionTarget[k] = std::max<Real>(0.0, -separation - constraints.penetrationSlop[k]) *
+                std::clamp<Real>(params.positionCorrectionPercent, 0.0, 1.0);
+            constraints.normalMass[k] = Real(1.0) / invMassSum;
+            constraints.tangentMass[k] = Real(1.0) / tangentK;
+            constraints.restitution[k] = std::clamp<Real>(params.restitution, 0.0, 1.0);
+            // Angular terms drop out of the normal velocity for sphere contacts.
+            constraints.velocityBias[k] = restitutionBias(constraints.restitution[k], (b.velocity - a.velocity).dot(n));
+            constraints.staticFriction[k] = std::max<Real>(0.0, params.staticFriction);
+            constraints.dynamicFriction[k] = std::max<Real>(0.0, params.dynamicFriction);
+            constraints.active[k] = 1;
+        }
+
+        // One accumulated normal + friction update of row k; the normal row drives the relative
+        // normal velocity towards targetNormalVelocity. massScale and impulseScale soften the
+        // normal row; 1 and 0 give the rigid row.
+        void solveAccumulatedRow(
+            ContactConstraints& constraints,
+            SolverBodies& bodies,
+            const std::size_t k,
+            const Real targetNormalVelocity,
+            const Real massScale = 1.0,
+            const Real impulseScale = 0.0)
+        {
+            const std::uint32_t a = constraints.bodyA[k];
+            const std::uint32_t b = constraints.bodyB[k];
+            const Real wA = bodies.invMass[a];
+            const Real wB = bodies.invMass[b];
+            const Real invIA = bodies.invInertia[a];
+            const Real invIB = bodies.invInertia[b];
+            const Vec3 n(constraints.normalX[k], constraints.normalY[k], constraints.normalZ[k]);
+            const Vec3 rA = n * constraints.offsetA[k];
+            const Vec3 rB = n * (-constraints.offsetB[k]);
+
+            Vec3& vA = bodies.velocity[a];
+            Vec3& vB = bodies.velocity[b];
+            Vec3& wAVel = bodies.angularVelocity[a];
+            Vec3& wBVel = bodies.angularVelocity[b];
+
+            // Normal row: clamp the running total, not the increment, so later iterations can
+            // take back impulse an earlier one over-applied.
+            const Vec3 rv = (vB + wBVel.cross(rB)) - (vA + wAVel.cross(rA));
+            const Real vN = rv.dot(n);
+            const Real oldNormal = constraints.normalImpulse[k];
+            const Real lambda =
+                -(vN - targetNormalVelocity) * constraints.normalMass[k] * massScale - impulseScale * oldNormal;
+            const Real newNormal = std::max<Real>(0.0, oldNormal + lambda);
+            if (!std::isfinite(newNormal)) {
+                return;
+            }
+            const Real delta = newNormal - oldNormal;
+            if (wA > Real(0.0)) {
+                vA -= n * (delta * wA);
+            }
+            if (wB > Real(0.0)) {
+                vB += n * (delta * wB);
+            }
+            constraints.normalImpulse[k] = newNormal;
+            if (newNormal > Real(0.0)) {
+                constraints.impulseApplied[k] = 1;
+            }
+
+            // Friction row: the tangent mass is the same in every tangent direction, so the whole
+            // tangential slip is removed at once and the total is clamped to the Coulomb cone.
+            const Vec3 rv2 = (vB + wBVel.cross(rB)) - (vA + wAVel.cross(rA));
+            const Vec3 slip = rv2 - n * rv2.dot(n);
+            const Vec3 oldFriction(
+                constraints.frictionImpulseX[k], constraints.frictionImpulseY[k], constraints.frictionImpulseZ[k]);
+            Vec3 newFriction = oldFriction - slip * constraints.tangentMass[k];
+            const Real len2 = newFriction.dot(newFriction);
+            const Real maxStatic = newNormal * constraints.staticFriction[k];
+            const Real scale = len2 > maxStatic * maxStatic
+                ? newNormal * constraints.dynamicFriction[k] / std::sqrt(len2)
+                : Real(1.0);
+            newFriction *= scale;
+            if (!isFinite(newFriction)) {
+                return;
+            }
+            const Vec3 impulse = newFriction - oldFriction;
+            if (wA > Real(0.0)) {
+                vA -= impulse * wA;
+                wAVel -= rA.cross(impulse) * invIA;
+            }
+            if (wB > Real(0.0)) {
+                vB += impulse * wB;
+                wBVel += rB.cross(impulse) * invIB;
+            }
+            constraints.frictionImpulseX[k] = newFriction.x;
+            constraints.frictionImpulseY[k] = newFriction.y;
+            constraints.frictionImpulseZ[k] = newFriction.z;
+        }
+    } // namespace
+
+    void prepareContact(
+        ContactConstraints& constraints,
+        const std::size_t k,
+        const Body& a,
+        const Body& b,
+        const std::uint32_t solverA,
+        const std::uint32_t solverB,
+        const SolveParams& params)
+    {
+        prepareRow(constraints, k, a, b, solverA, solverB, params, true);
+    }
+
+    void prepareSpeculativeContact(
+        ContactConstraints& constraints,
+        const std::size_t k,
+        const Body& a,
+        const Body& b,
+        const std::uint32_t solverA,
+        const std::uint32_t solverB,
+        const SolveParams& params)
+    {
+        prepareRow(constraints, k, a, b, solverA, solverB, params, false);
+    }
+
+    void warmStartContact(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        const std::size_t k,
+        const Real normalImpulse,
+        const Vec3& frictionImpulse,
+        const bool applyToBodies)
+    {
+        if (constraints.active[k] == 0 || !std::isfinite(normalImpulse) || normalImpulse <= Real(0.0) ||
+            !isFinite(frictionImpulse)) {
+            return;
+        }
+
+        // The cached friction may predate a small change of normal; keep only its tangential part.
+        const Vec3 n(constraints.normalX[k], constraints.normalY[k], constraints.normalZ[k]);
+        const Vec3 friction = frictionImpulse - n * frictionImpulse.dot(n);
+        constraints.normalImpulse[k] = normalImpulse;
+        constraints.frictionImpulseX[k] = friction.x;
+        constraints.frictionImpulseY[k] = friction.y;
+        constraints.frictionImpulseZ[k] = friction.z;
+        if (!applyToBodies) {
+            return;
+        }
+
+        const std::uint32_t a = constraints.bodyA[k];
+        const std::uint32_t b = constraints.bodyB[k];
+        const Vec3 impulse = n * normalImpulse + friction;
+        if (bodies.invMass[a] > Real(0.0)) {
+            bodies.velocity[a] -= impulse * bodies.invMass[a];
+            bodies.angularVelocity[a] -= (n * constraints.offsetA[k]).cross(friction) * bodies.invInertia[a];
+        }
+        if (bodies.invMass[b] > Real(0.0)) {
+            bodies.velocity[b] += impulse * bodies.invMass[b];
+            bodies.angularVelocity[b] += (n * (-constraints.offsetB[k])).cross(friction) * bodies.invInertia[b];
+        }
+    }
+
+    void updateVelocityBias(ContactConstraints& constraints, const SolverBodies& bodies, const std::size_t k)
+    {
+        if (constraints.active[k] == 0) {
+            return;
+        }
+        const Vec3 n(constraints.normalX[k], constraints.normalY[k], constraints.normalZ[k]);
+        const Real approach = (bodies.velocity[constraints.bodyB[k]] - bodies.velocity[constraints.bodyA[k]]).dot(n);
+        constraints.velocityBias[k] = restitutionBias(constraints.restitution[k], approach);
+    }
+
+    void solveContactVelocities(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        const std::size_t begin,
+        const std::size_t end,
+        const ImpulseMode mode,
+        const bool splitImpulse)
+    {
+        if (mode == ImpulseMode::Accumulated) {
+            solveAccumulatedContactVelocities(constraints, bodies, begin, end, splitImpulse);
+            return;
+        }
+
+        for (std::size_t k = begin; k < end; ++k) {
+            if (splitImpulse) {
+                solvePositionRow(constraints, bodies, k);
+            }
+            if (constraints.active[k] == 0) {
+                continue;
+            }
+
+            const std::uint32_t a = constraints.bodyA[k];
+            const std::uint32_t b = constraints.bodyB[k];
+            const Real wA = bodies.invMass[a];
+            const Real wB = bodies.invMass[b];
+            const Real invIA = bodies.invInertia[a];
+            const Real invIB = bodies.invInertia[b];
+            const Vec3 n(constraints.normalX[k], constraints.normalY[k], constraints.normalZ[k]);
+            const Vec3 rA = n * constraints.offsetA[k];
+            const Vec3 rB = n * (-constraints.offsetB[k]);
+
+            Vec3& vA = bodies.velocity[a];
+            Vec3& vB = bodies.velocity[b];
+            Vec3& wAVel = bodies.angularVelocity[a];
+            Vec3& wBVel = bodies.angularVelocity[b];
+
+            const Vec3 rv = (vB + wBVel.cross(rB)) - (vA + wAVel.cross(rA));
+            const Real vN = rv.dot(n);
+            if (vN >= Real(0.0)) {
+                continue;
+            }
+
+            const Real restitution =
+                std::abs(vN) > kRestitutionVelocityThreshold ? constraints.restitution[k] : Real(0.0);
+            const Real normalImpulse = std::max<Real>(0.0, -(Real(1.0) + restitution) * vN * constraints.normalMass[k]);
+            if (!std::isfinite(normalImpulse) || normalImpulse <= Real(0.0)) {
+                continue;
+            }
+            // The normal row has no angular part: r x n == 0 for sphere contacts.
+            if (wA > Real(0.0)) {
+                vA -= n * (normalImpulse * wA);
+            }
+            if (wB > Real(0.0)) {
+                vB += n * (normalImpulse * wB);
+            }
+            constraints.normalImpulse[k] += normalImpulse;
+            constraints.impulseApplied[k] = 1;
+
+            // Coulomb friction: solve tangent impulse after normal impulse update.
+            const Vec3 rv2 = (vB + wBVel.cross(rB)) - (vA + wAVel.cross(rA));
+            const Vec3 tangentUnscaled = rv2 - n * rv2.dot(n);
+            const Real tangentLen2 = tangentUnscaled.dot(tangentUnscaled);
+            if (!(tangentLen2 > Real(1e-24))) {
+                continue;
+            }
+            const Vec3 t = tangentUnscaled / std::sqrt(tangentLen2);
+            const Real jt = -rv2.dot(t) * constraints.tangentMass[k];
+            if (!std::isfinite(jt)) {
+                continue;
+            }
+
+            const Real maxStatic = normalImpulse * constraints.staticFriction[k];
+            const Real tangentImpulse = std::abs(jt) <= maxStatic
+                ? jt
+                : -normalImpulse * constraints.dynamicFriction[k] * std::copysign(Real(1.0), jt);
+            const Vec3 impulse = t * tangentImpulse;
+            if (!isFinite(impulse)) {
+                continue;
+            }
+            if (wA > Real(0.0)) {
+                vA -= impulse * wA;
+                wAVel -= rA.cross(impulse) * invIA;
+            }
+            if (wB > Real(0.0)) {
+                vB += impulse * wB;
+                wBVel += rB.cross(impulse) * invIB;
+            }
+        }
+    }
+
+    void solveAccumulatedContactVelocities(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        const std::size_t begin,
+        const std::size_t end,
+        const bool splitImpulse)
+    {
+        for (std::size_t k = begin; k < end; ++k) {
+            if (splitImpulse) {
+                solvePositionRow(constraints, bodies, k);
+            }
+            if (constraints.active[k] != 0) {
+                solveAccumulatedRow(constraints, bodies, k, constraints.velocityBias[k]);
+            }
+        }
+    }
+
+    SoftContact softContact(const Real hertz, const Real dampingRatio, const Real h, const Real maxPushVelocity)
+    {
+        SoftContact soft{};
+        if (!(hertz > Real(0.0)) || !(h > Real(0.0))) {
+            return soft;
+        }
+        const Real omega = Real(2.0) * Real(3.14159265358979323846) * hertz;
+        const Real a1 = Real(2.0) * dampingRatio + h * omega;
+        const Real a2 = h * omega * a1;
+        const Real a3 = Real(1.0) / (Real(1.0) + a2);
+        soft.biasRate = omega / a1;
+        soft.massScale = a2 * a3;
+        soft.impulseScale = a3;
+        soft.maxPushVelocity = std::max<Real>(0.0, maxPushVelocity);
+        return soft;
+    }
+
+    void solveContactSubstep(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        const std::size_t begin,
+        const std::size_t end,
+        const Real invH,
+        const SoftContact& soft,
+        const bool useBias)
+    {
+        for (std::size_t k = begin; k < end; ++k) {
+            if (constraints.active[k] == 0) {
+                continue;
+            }
+            // Gap after the displacement so far this step; rotation never changes a sphere gap.
+            const Vec3 n(constraints.normalX[k], constraints.normalY[k], constraints.normalZ[k]);
+            const Vec3 moved = bodies.deltaPosition[constraints.bodyB[k]] - bodies.deltaPosition[constraints.bodyA[k]];
+            const Real gap = constraints.separation[k] + moved.dot(n);
+            if (gap > Real(0.0)) {
+                // Speculative: the pair may close at most the remaining gap within this substep.
+                solveAccumulatedRow(constraints, bodies, k, -gap * invH);
+            } else if (useBias) {
+                const Real depth = std::min<Real>(0.0, gap + constraints.penetrationSlop[k]);
+                const Real push = std::min(-soft.biasRate * depth, soft.maxPushVelocity);
+                solveAccumulatedRow(constraints, bodies, k, push, soft.massScale, soft.impulseScale);
+            } else {
+                solveAccumulatedRow(constraints, bodies, k, 0.0);
+            }
+        }
+    }
+
+    void applyContactImpulses(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        const std::size_t begin,
+        const std::size_t end)
+    {
+        for (std::size_t k = begin; k < end; ++k) {
+            const Vec3 friction(
+                constraints.frictionImpulseX[k], constraints.frictionImpulseY[k], constraints.frictionImpulseZ[k]);
+            warmStartContact(constraints, bodies, k, constraints.normalImpulse[k], friction, true);
+        }
+    }
+
+    void applyContactRestitution(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        const std::size_t begin,
+        const std::size_t end)
+    {
+        for (std::size_t k = begin; k < end; ++k) {
+            if (constraints.active[k] == 0 || constraints.velocityBias[k] <= Real(0.0) ||
+                constraints.impulseApplied[k] == 0) {
+                continue;
+            }
+            const std::uint32_t a = constraints.bodyA[k];
+            const std::uint32_t b = constraints.bodyB[k];
+            const Vec3 n(constraints.normalX[k], constraints.normalY[k], constraints.normalZ[k]);
+            const Real vN = (bodies.velocity[b] - bodies.velocity[a]).dot(n);
+            const Real oldNormal = constraints.normalImpulse[k];
+            const Real newNormal =
+                std::max<Real>(0.0, oldNormal - (vN - constraints.velocityBias[k]) * constraints.normalMass[k]);
+            if (!std::isfinite(newNormal)) {
+                continue;
+            }
+            const Real delta = newNormal - oldNormal;
+            if (bodies.invMass[a] > Real(0.0)) {
+                bodies.velocity[a] -= n * (delta * bodies.invMass[a]);
+            }
+            if (bodies.invMass[b] > Real(0.0)) {
+                bodies.velocity[b] += n * (delta * bodies.invMass[b]);
+            }
+            constraints.normalImpulse[k] = newNormal;
+        }
+    }
+
+    void solveContactVelocitiesWide(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        const std::size_t begin,
+        const std::size_t end,
+        const std::size_t lanes,
+        const ImpulseMode mode,
+        const bool splitImpulse)
+    {
+        if (lanes >= 8) {
+            solveLaneGroups<8>(constraints, bodies, begin, end, mode, splitImpulse);
+        } else if (lanes >= 4) {
+            solveLaneGroups<4>(constraints, bodies, begin, end, mode, splitImpulse);
+        } else {
+            solveContactVelocities(constraints, bodies, begin, end, mode, splitImpulse);
+        }
+    }
+
+} // namespace sim::collision
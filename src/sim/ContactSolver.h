@@ -0,0 +1,180 @@
+#ifndef PHYSICS3D_CONTACTSOLVER_H
+#define PHYSICS3D_CONTACTSOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Body.h"
+#include "Collision.h"
+
+namespace sim::collision {
+
+    // PerIteration: every velocity iteration computes a fresh impulse from the current relative
+    // velocity (clamped to push only) and normalImpulse sums them. Accumulated: normalImpulse and
+    // frictionImpulse hold running totals that are clamped as a whole (normal >= 0, friction inside
+    // the Coulomb cone), so rows can be warm-started exactly from the previous step's totals.
+    enum class ImpulseMode {
+        PerIteration,
+        Accumulated,
+    };
+
+    // Compact copy of the velocity state of every body referenced by a contact solve.
+    struct SolverBodies {
+        std::vector<std::size_t> bodyIndex{};
+        std::vector<Vec3> velocity{};
+        std::vector<Vec3> angularVelocity{};
+        std::vector<Vec3> deltaPosition{}; // Displacement since the rows were prepared: small steps or split-impulse correction
+        std::vector<Real> invMass{};
+        std::vector<Real> invInertia{};
+
+        void clear();
+        [[nodiscard]] std::size_t size() const;
+        std::uint32_t add(const Body& body, std::size_t index);
+        // Writes velocities back to dynamic bodies only; static bodies are never touched.
+        void scatter(std::span<Body> bodies) const;
+        // Moves every body by its deltaPosition.
+        void applyDisplacement(std::span<Body> bodies) const;
+    };
+
+    // Sphere contact rows in structure-of-arrays form, prepared once per solve. The contact
+    // offsets are normal * offsetA on body A and -normal * offsetB on body B, which keeps the
+    // normal row free of angular terms and makes the tangent mass independent of direction.
+    struct ContactConstraints {
+        std::vector<std::uint32_t> bodyA{};
+        std::vector<std::uint32_t> bodyB{};
+        std::vector<Real> normalX{};
+        std::vector<Real> normalY{};
+        std::vector<Real> normalZ{};
+        std::vector<Real> offsetA{};
+        std::vector<Real> offsetB{};
+        std::vector<Real> separation{}; // Gap along the normal when prepared; negative when overlapping
+        std::vector<Real> penetrationSlop{};
+        std::vector<Real> positionTarget{}; // Split impulse: push-out distance, percent * (depth - slop)
+        std::vector<Real> positionImpulse{};
+        std::vector<Real> normalMass{};
+        std::vector<Real> tangentMass{};
+        std::vector<Real> restitution{};
+        std::vector<Real> velocityBias{}; // Restitution target for the accumulated normal row
+        std::vector<Real> staticFriction{};
+        std::vector<Real> dynamicFriction{};
+        std::vector<Real> normalImpulse{};
+        std::vector<Real> frictionImpulseX{};
+        std::vector<Real> frictionImpulseY{};
+        std::vector<Real> frictionImpulseZ{};
+        std::vector<std::uint8_t> active{};
+        std::vector<std::uint8_t> impulseApplied{};
+
+        void resize(std::size_t count);
+        [[nodiscard]] std::size_t size() const;
+    };
+
+    // Fills row k from the current pose of a and b. Rows for separated or massless pairs stay inactive.
+    void prepareContact(
+        ContactConstraints& constraints,
+        std::size_t k,
+        const Body& a,
+        const Body& b,
+        std::uint32_t solverA,
+        std::uint32_t solverB,
+        const SolveParams& params);
+
+    // Same as prepareContact, but separated pairs get a row too. Used by the small-step solver,
+    // which prepares rows once per step for every pair that may touch during it.
+    void prepareSpeculativeContact(
+        ContactConstraints& constraints,
+        std::size_t k,
+        const Body& a,
+        const Body& b,
+        std::uint32_t solverA,
+        std::uint32_t solverB,
+        const SolveParams& params);
+
+    // Seeds row k with cached accumulated totals. applyToBodies is false when the totals are
+    // already contained in the body velocities (the pair was solved earlier in the same step).
+    void warmStartContact(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        std::size_t k,
+        Real normalImpulse,
+        const Vec3& frictionImpulse,
+        bool applyToBodies);
+
+    // Recomputes the restitution target of row k from the current body velocities. Called after
+    // warm starting, so a resting contact whose approach the cached impulse cancels does not bounce.
+    void updateVelocityBias(ContactConstraints& constraints, const SolverBodies& bodies, std::size_t k);
+
+    // One sequential velocity sweep over rows [begin, end). With splitImpulse each row also runs
+    // its position row in the same pass: penetration is resolved through the pseudo displacement
+    // in SolverBodies::deltaPosition, which the caller adds to the positions after the last sweep.
+    void solveContactVelocities(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        std::size_t begin,
+        std::size_t end,
+        ImpulseMode mode = ImpulseMode::PerIteration,
+        bool splitImpulse = false);
+
+    void solveAccumulatedContactVelocities(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        std::size_t begin,
+        std::size_t end,
+        bool splitImpulse = false);
+
+    // Soft position bias for the small-step solver, in mass-spring-damper form: the contact
+    // behaves like a stiff damped spring of the given frequency instead of a rigid Baumgarte
+    // term, which would keep re-injecting push-out velocity at small substeps.
+    struct SoftContact {
+        Real biasRate = 0.0;
+        Real massScale = 1.0;
+        Real impulseScale = 0.0;
+        Real maxPushVelocity = 0.0;
+    };
+
+    [[nodiscard]] SoftContact softContact(Real hertz, Real dampingRatio, Real h, Real maxPushVelocity);
+
+    // Small-step (TGS) sweep with accumulated totals. The gap of each row is tracked from the
+    // prepared separation plus deltaPosition: separated rows allow closing up to gap / h, and
+    // with useBias penetration beyond the slop is pushed out through the soft bias. The relax
+    // sweep after each substep's position update runs with useBias false.
+    void solveContactSubstep(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        std::size_t begin,
+        std::size_t end,
+        Real invH,
+        const SoftContact& soft,
+        bool useBias);
+
+    // Applies the current totals of rows [begin, end) to the body velocities again. The small-step
+    // solver warm-starts every substep this way, since each substep needs its own support impulse.
+    void applyContactImpulses(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        std::size_t begin,
+        std::size_t end);
+
+    // Restitution pass after the last substep: rows that were hit fast enough and pushed in any
+    // substep are driven to their velocityBias separation speed.
+    void applyContactRestitution(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        std::size_t begin,
+        std::size_t end);
+
+    // Same sweep, solving `lanes` rows (4 or 8) at a time: gather the body velocities, compute
+    // all impulses branch-free, scatter back. Rows in [begin, end) must not share a dynamic body.
+    // Produces the same result as solveContactVelocities over the same rows.
+    void solveContactVelocitiesWide(
+        ContactConstraints& constraints,
+        SolverBodies& bodies,
+        std::size_t begin,
+        std::size_t end,
+        std::size_t lanes,
+        ImpulseMode mode = ImpulseMode::PerIteration,
+        bool splitImpulse = false);
+
+} // namespace sim::collision
+
+#endif // PHYSICS3D_CONTACTSOLVER_H
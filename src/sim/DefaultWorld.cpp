@@ -12,47 +12,47 @@
 
 namespace sim {
     namespace {
-        constexpr double kGravityStrength = World::Params::kDefaultG;
-        constexpr double kMinRadius = 0.05;
-        constexpr double kPi = 3.14159265358979323846;
+        constexpr Real kGravityStrength = World::Params::kDefaultG;
+        constexpr Real kMinRadius = 0.05;
+        constexpr Real kPi = 3.14159265358979323846;
 
         struct BodySpec {
             Vec3 position;
-            double radius = 1.0;
-            double density = 1.0;
+            Real radius = 1.0;
+            Real density = 1.0;
             Vec3 velocity{};
             Vec3 angularVelocity{};
         };
 
-        [[nodiscard]] double sphereMass(const double radius, const double density) {
-            if (!std::isfinite(radius) || radius <= 0.0 || !std::isfinite(density) || density <= 0.0) {
+        [[nodiscard]] Real sphereMass(const Real radius, const Real density) {
+            if (!std::isfinite(radius) || radius <= Real(0.0) || !std::isfinite(density) || density <= Real(0.0)) {
                 return 0.0;
             }
-            return (4.0 / 3.0) * kPi * radius * radius * radius * density;
+            return (Real(4.0) / Real(3.0)) * kPi * radius * radius * radius * density;
         }
 
         [[nodiscard]] Vec3 tangentialDirection(const Vec3& radial) {
-            const double r2 = radial.x * radial.x + radial.y * radial.y;
-            if (!(r2 > 0.0)) {
+            const Real r2 = radial.x * radial.x + radial.y * radial.y;
+            if (!(r2 > Real(0.0))) {
                 return Vec3{};
             }
-            const double invR = 1.0 / std::sqrt(r2);
+            const Real invR = Real(1.0) / std::sqrt(r2);
             return Vec3(-radial.y * invR, radial.x * invR, 0.0);
         }
 
         [[nodiscard]] Vec3 circularOrbitVelocity(
             const Vec3& orbitCenter,
             const Vec3& position,
-            const double primaryMass,
-            const double secondaryMass = 0.0)
+            const Real primaryMass,
+            const Real secondaryMass = 0.0)
         {
             const Vec3 radial = position - orbitCenter;
-            const double orbitalRadius = std::sqrt(radial.x * radial.x + radial.y * radial.y + radial.z * radial.z);
-            if (!(orbitalRadius > 0.0) || !(primaryMass > 0.0)) {
+            const Real orbitalRadius = std::sqrt(radial.x * radial.x + radial.y * radial.y + radial.z * radial.z);
+            if (!(orbitalRadius > Real(0.0)) || !(primaryMass > Real(0.0))) {
                 return Vec3{};
             }
 
-            const double speed = std::sqrt(kGravityStrength * (primaryMass + std::max(0.0, secondaryMass)) / orbitalRadius);
+            const Real speed = std::sqrt(kGravityStrength * (primaryMass + std::max<Real>(0.0, secondaryMass)) / orbitalRadius);
             return tangentialDirection(radial) * speed;
         }
 
@@ -67,29 +67,29 @@ namespace sim {
             b.angularVelocity = spec.angularVelocity;
             b.radius = std::max(kMinRadius, spec.radius);
 
-            const double mass = sphereMass(b.radius, spec.density);
-            b.invMass = mass > 0.0 ? (1.0 / mass) : 0.0;
+            const Real mass = sphereMass(b.radius, spec.density);
+            b.invMass = mass > Real(0.0) ? (Real(1.0) / mass) : Real(0.0);
             assignMaterial(b, kDefaultMaterialName);
             bodies.push_back(b);
             return bodies.size() - 1;
         }
 
         void recenterSystem(std::vector<Body>& bodies) {
-            double totalMass = 0.0;
+            Real totalMass = 0.0;
             Vec3 centerOfMass{};
             Vec3 totalMomentum{};
 
             for (const Body& body : bodies) {
-                if (!(body.invMass > 0.0) || !std::isfinite(body.invMass)) {
+                if (!(body.invMass > Real(0.0)) || !std::isfinite(body.invMass)) {
                     continue;
                 }
-                const double mass = 1.0 / body.invMass;
+                const Real mass = Real(1.0) / body.invMass;
                 totalMass += mass;
                 centerOfMass += body.position * mass;
                 totalMomentum += body.velocity * mass;
             }
 
-            if (!(totalMass > 0.0)) {
+            if (!(totalMass > Real(0.0))) {
                 return;
             }
 
@@ -123,7 +123,7 @@ namespace sim {
             .density = 1.25e9,
             .angularVelocity = Vec3(0.0, 0.08, 0.0),
         };
-        const double starMass = sphereMass(star.radius, star.density);
+        const Real starMass = sphereMass(star.radius, star.density);
 
         BodySpec innerPlanet{
             .position = Vec3(0.0, 15.5, 0.0),
@@ -131,7 +131,7 @@ namespace sim {
             .density = 3.4e8,
             .angularVelocity = Vec3(0.0, 0.4, 0.0),
         };
-        const double innerPlanetMass = sphereMass(innerPlanet.radius, innerPlanet.density);
+        const Real innerPlanetMass = sphereMass(innerPlanet.radius, innerPlanet.density);
         innerPlanet.velocity = circularOrbitVelocity(star.position, innerPlanet.position, starMass, innerPlanetMass);
 
         BodySpec outerPlanet{
@@ -140,7 +140,7 @@ namespace sim {
             .density = 2.6e8,
             .angularVelocity = Vec3(0.0, 0.22, 0.0),
         };
-        const double outerPlanetMass = sphereMass(outerPlanet.radius, outerPlanet.density);
+        const Real outerPlanetMass = sphereMass(outerPlanet.radius, outerPlanet.density);
         outerPlanet.velocity = circularOrbitVelocity(star.position, outerPlanet.position, starMass, outerPlanetMass);
 
         BodySpec gasGiant{
@@ -149,7 +149,7 @@ namespace sim {
             .density = 8.5e7,
             .angularVelocity = Vec3(0.0, 0.12, 0.0),
         };
-        const double gasGiantMass = sphereMass(gasGiant.radius, gasGiant.density);
+        const Real gasGiantMass = sphereMass(gasGiant.radius, gasGiant.density);
         gasGiant.velocity = circularOrbitVelocity(star.position, gasGiant.position, starMass, gasGiantMass);
 
         BodySpec moon{
@@ -158,7 +158,7 @@ namespace sim {
             .density = 3.0e8,
             .angularVelocity = Vec3(0.0, 0.6, 0.0),
         };
-        const double moonMass = sphereMass(moon.radius, moon.density);
+        const Real moonMass = sphereMass(moon.radius, moon.density);
         moon.velocity =
             gasGiant.velocity + circularOrbitVelocity(gasGiant.position, moon.position, gasGiantMass, moonMass);
 
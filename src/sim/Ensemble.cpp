@@ -0,0 +1,104 @@
+#include "Ensemble.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+namespace sim {
+    namespace {
+        void summarize(const World& world, const World::StepStats& stats, Ensemble::MemberSummary& out)
+        {
+            out.steps += stats.steps;
+            out.simulatedTime += stats.simulatedTime;
+            out.substeps = stats.substeps;
+            out.awakeBodySteps = stats.awakeBodySteps;
+            out.sleepingBodies = stats.sleepingBodies;
+            out.contactManifolds = stats.contactManifolds;
+
+            Real kineticEnergy = 0.0;
+            Real totalMass = 0.0;
+            Vec3 momentum{};
+            Vec3 weightedPosition{};
+            for (const Body& body : world.bodies()) {
+                if (!(body.invMass > Real(0.0)) || !std::isfinite(body.invMass)) {
+                    continue;
+                }
+                const Real mass = Real(1.0) / body.invMass;
+                kineticEnergy += Real(0.5) * mass * body.velocity.dot(body.velocity);
+                momentum += body.velocity * mass;
+                weightedPosition += body.position * mass;
+                totalMass += mass;
+            }
+            out.kineticEnergy = kineticEnergy;
+            out.momentum = momentum;
+            out.centerOfMass = totalMass > Real(0.0) ? weightedPosition / totalMass : Vec3{};
+            out.stateHash = world.stateHash();
+        }
+    } // namespace
+
+    double Ensemble::Stats::memberStepsPerSecond() const
+    {
+        return wallSeconds > 0.0 ? static_cast<double>(memberSteps) / wallSeconds : 0.0;
+    }
+
+    double Ensemble::Stats::bodyStepsPerSecond() const
+    {
+        return wallSeconds > 0.0 ? static_cast<double>(awakeBodySteps) / wallSeconds : 0.0;
+    }
+
+    Ensemble::Ensemble(const int workerThreads)
+        : jobs_(std::make_unique<jobs::JobSystem>(std::clamp(workerThreads, 1, World::Params::kMaxWorkerThreads)))
+    {
+    }
+
+    std::size_t Ensemble::add(World world)
+    {
+        world.params().workerThreads = 1;
+        members_.push_back(std::move(world));
+        summaries_.emplace_back();
+        return members_.size() - 1;
+    }
+
+    void Ensemble::reserve(const std::size_t members)
+    {
+        members_.reserve(members);
+        summaries_.reserve(members);
+    }
+
+    std::size_t Ensemble::size() const { return members_.size(); }
+    World& Ensemble::member(const std::size_t index) { return members_[index]; }
+    const World& Ensemble::member(const std::size_t index) const { return members_[index]; }
+    const Ensemble::MemberSummary& Ensemble::summary(const std::size_t index) const { return summaries_[index]; }
+
+    Ensemble::Stats Ensemble::advance(const int steps, const Real dt)
+    {
+        Stats stats{};
+        stats.members = members_.size();
+        stats.steps = std::max(steps, 0);
+        if (stats.steps == 0 || members_.empty()) {
+            return stats;
+        }
+
+        // One member per chunk: members differ in cost (some settle and sleep, some collide), and
+        // the pool balances single members by stealing.
+        const auto start = std::chrono::steady_clock::now();
+        jobs_->parallelFor(members_.size(), 1, [this, steps, dt](const std::size_t begin, const std::size_t end) {
+            for (std::size_t m = begin; m < end; ++m) {
+                // Edits through member() may have raised workerThreads again.
+                members_[m].params().workerThreads = 1;
+                const World::StepStats memberStats = members_[m].advance(steps, dt);
+                summarize(std::as_const(members_[m]), memberStats, summaries_[m]);
+            }
+        });
+        stats.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (const MemberSummary& summary : summaries_) {
+            stats.substeps += static_cast<std::uint64_t>(summary.substeps);
+            stats.awakeBodySteps += summary.awakeBodySteps;
+        }
+        stats.memberSteps = static_cast<std::uint64_t>(stats.steps) * members_.size();
+        return stats;
+    }
+
+} // namespace sim
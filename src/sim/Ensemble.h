@@ -0,0 +1,72 @@
+#ifndef PHYSICS3D_ENSEMBLE_H
+#define PHYSICS3D_ENSEMBLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "JobSystem.h"
+#include "World.h"
+
+namespace sim {
+
+    // Many independent worlds stepped together, for Monte Carlo runs and parameter sweeps.
+    // Members are spread over one pool rather than each using its own: a member runs all steps
+    // of an advance() call in one go on one thread, so its bodies, contact cache and scratch stay
+    // in that core's cache, and members are small enough that splitting one across threads would
+    // cost more than it saves. Every member is therefore forced to workerThreads = 1.
+    //
+    // After each advance() every member gets a summary, read from its state in place, so
+    // comparing hundreds of members never copies their bodies.
+    class Ensemble {
+    public:
+        struct MemberSummary {
+            int steps = 0; // Since the member was added
+            Real simulatedTime = 0.0;
+            int substeps = 0; // In the last advance()
+            std::uint64_t awakeBodySteps = 0; // In the last advance()
+            Real kineticEnergy = 0.0; // Linear only
+            Vec3 momentum{};
+            Vec3 centerOfMass{}; // Of dynamic bodies
+            std::size_t sleepingBodies = 0;
+            std::size_t contactManifolds = 0;
+            std::uint64_t stateHash = 0;
+        };
+
+        // Totals over one advance() call.
+        struct Stats {
+            std::size_t members = 0;
+            int steps = 0; // Per member
+            std::uint64_t memberSteps = 0;
+            std::uint64_t substeps = 0;
+            std::uint64_t awakeBodySteps = 0;
+            double wallSeconds = 0.0;
+
+            [[nodiscard]] double memberStepsPerSecond() const;
+            [[nodiscard]] double bodyStepsPerSecond() const;
+        };
+
+        explicit Ensemble(int workerThreads = 1);
+
+        // Returns the new member's index. Members keep their index for the ensemble's lifetime.
+        std::size_t add(World world);
+        void reserve(std::size_t members);
+
+        [[nodiscard]] std::size_t size() const;
+        [[nodiscard]] World& member(std::size_t index);
+        [[nodiscard]] const World& member(std::size_t index) const;
+        [[nodiscard]] const MemberSummary& summary(std::size_t index) const;
+
+        // Steps every member steps times by dt, in parallel, and refreshes every summary.
+        Stats advance(int steps, Real dt);
+
+    private:
+        std::vector<World> members_{};
+        std::vector<MemberSummary> summaries_{};
+        std::unique_ptr<jobs::JobSystem> jobs_{};
+    };
+
+} // namespace sim
+
+#endif // PHYSICS3D_ENSEMBLE_H
@@ -0,0 +1,154 @@
+#ifndef PHYSICS3D_FLATPAIRMAP_H
+#define PHYSICS3D_FLATPAIRMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace sim {
+
+    // Open-addressing map from a pair of ids to Value. Entries live densely in insertion order
+    // (erase moves the last entry into the hole), so iteration is a linear scan. The slot table
+    // uses linear probing with backward-shift deletion, so there are no tombstones. Storage only
+    // grows; once warmed up, insert and erase never allocate.
+    template <typename Value>
+    class FlatPairMap {
+    public:
+        using Key = std::pair<std::uint64_t, std::uint64_t>;
+
+        [[nodiscard]] std::size_t size() const { return keys_.size(); }
+        [[nodiscard]] bool empty() const { return keys_.empty(); }
+
+        [[nodiscard]] const Key& keyAt(const std::size_t index) const { return keys_[index]; }
+        [[nodiscard]] Value& valueAt(const std::size_t index) { return values_[index]; }
+        [[nodiscard]] const Value& valueAt(const std::size_t index) const { return values_[index]; }
+
+        void clear()
+        {
+            keys_.clear();
+            values_.clear();
+            slots_.assign(slots_.size(), kEmpty);
+        }
+
+        [[nodiscard]] Value* find(const Key& key)
+        {
+            const std::size_t slot = findSlot_(key);
+            return slot == kNotFound ? nullptr : &values_[slots_[slot]];
+        }
+
+        // Returns the entry for key, inserting a value-initialized one if it is missing.
+        Value& operator[](const Key& key)
+        {
+            if (const std::size_t slot = findSlot_(key); slot != kNotFound) {
+                return values_[slots_[slot]];
+            }
+            if ((keys_.size() + 1) * 2 > slots_.size()) {
+                rehash_(slots_.empty() ? kMinSlots : slots_.size() * 2);
+            }
+            const auto index = static_cast<std::uint32_t>(keys_.size());
+            keys_.push_back(key);
+            values_.push_back(Value{});
+            std::size_t slot = home_(key);
+            while (slots_[slot] != kEmpty) {
+                slot = (slot + 1) & mask_();
+            }
+            slots_[slot] = index;
+            return values_.back();
+        }
+
+        // Erases entries for which pred(key, value) is true; one pass over the dense entries.
+        template <typename Pred>
+        void eraseIf(Pred&& pred)
+        {
+            std::size_t index = 0;
+            while (index < keys_.size()) {
+                if (pred(keys_[index], values_[index])) {
+                    eraseAt_(index);
+                } else {
+                    ++index;
+                }
+            }
+        }
+
+    private:
+        static constexpr std::uint32_t kEmpty = std::numeric_limits<std::uint32_t>::max();
+        static constexpr std::size_t kNotFound = std::numeric_limits<std::size_t>::max();
+        static constexpr std::size_t kMinSlots = 64;
+
+        std::vector<Key> keys_{};
+        std::vector<Value> values_{};
+        std::vector<std::uint32_t> slots_{};
+
+        [[nodiscard]] std::size_t mask_() const { return slots_.size() - 1; }
+
+        [[nodiscard]] std::size_t home_(const Key& key) const
+        {
+            // splitmix64 finalizer over both ids: body ids are a small slot index plus a generation.
+            std::uint64_t h = key.first * 0x9e3779b97f4a7c15ULL ^ (key.second + 0x632be59bd9b4e019ULL);
+            h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+            h ^= h >> 31;
+            return static_cast<std::size_t>(h) & mask_();
+        }
+
+        [[nodiscard]] std::size_t findSlot_(const Key& key) const
+        {
+            if (keys_.empty()) {
+                return kNotFound;
+            }
+            for (std::size_t slot = home_(key);; slot = (slot + 1) & mask_()) {
+                const std::uint32_t index = slots_[slot];
+                if (index == kEmpty) {
+                    return kNotFound;
+                }
+                if (keys_[index] == key) {
+                    return slot;
+                }
+            }
+        }
+
+        void rehash_(const std::size_t slotCount)
+        {
+            slots_.assign(slotCount, kEmpty);
+            for (std::size_t index = 0; index < keys_.size(); ++index) {
+                std::size_t slot = home_(keys_[index]);
+                while (slots_[slot] != kEmpty) {
+                    slot = (slot + 1) & mask_();
+                }
+                slots_[slot] = static_cast<std::uint32_t>(index);
+            }
+        }
+
+        void eraseAt_(const std::size_t index)
+        {
+            // Backward-shift deletion keeps every probe chain contiguous.
+            std::size_t hole = findSlot_(keys_[index]);
+            for (std::size_t next = (hole + 1) & mask_(); slots_[next] != kEmpty; next = (next + 1) & mask_()) {
+                const std::size_t home = home_(keys_[slots_[next]]);
+                // Move the entry back unless its home lies cyclically in (hole, next].
+                const bool homeInRange = hole <= next
+                    ? (hole < home && home <= next)
+                    : (hole < home || home <= next);
+                if (!homeInRange) {
+                    slots_[hole] = slots_[next];
+                    hole = next;
+                }
+            }
+            slots_[hole] = kEmpty;
+
+            const std::size_t last = keys_.size() - 1;
+            if (index != last) {
+                slots_[findSlot_(keys_[last])] = static_cast<std::uint32_t>(index);
+                keys_[index] = keys_[last];
+                values_[index] = std::move(values_[last]);
+            }
+            keys_.pop_back();
+            values_.pop_back();
+        }
+    };
+
+} // namespace sim
+
+#endif // PHYSICS3D_FLATPAIRMAP_H
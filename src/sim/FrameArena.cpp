@@ -0,0 +1,118 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <new>
+
+namespace sim {
+    namespace {
+        [[nodiscard]] std::size_t alignUp(const std::size_t value, const std::size_t alignment) {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    } // namespace
+
+    FrameArena::~FrameArena()
+    {
+        release();
+    }
+
+    void FrameArena::reset()
+    {
+        highWaterMark_ = std::max(highWaterMark_, frameBytes_);
+        recentPeak_ = std::max(recentPeak_, frameBytes_);
+        if (!spill_.empty()) {
+            // Replace the spilled blocks by one block that holds the whole frame.
+            const std::size_t needed = alignUp(frameBytes_, kBlockAlignment);
+            for (Block& spilled : spill_) {
+                freeBlock_(spilled);
+            }
+            spill_.clear();
+            freeBlock_(block_);
+            block_ = allocateBlock_(std::max(needed, kMinBlockSize));
+            oversizedFrames_ = 0;
+            recentPeak_ = frameBytes_;
+        } else if (block_.size > kMinBlockSize && frameBytes_ * kShrinkRatio < block_.size) {
+            if (++oversizedFrames_ >= kShrinkAfterFrames) {
+                const std::size_t target = std::max(alignUp(recentPeak_ * 2, kBlockAlignment), kMinBlockSize);
+                freeBlock_(block_);
+                block_ = allocateBlock_(target);
+                oversizedFrames_ = 0;
+                recentPeak_ = 0;
+            }
+        } else {
+            oversizedFrames_ = 0;
+            recentPeak_ = 0;
+        }
+        offset_ = 0;
+        frameBytes_ = 0;
+    }
+
+    void FrameArena::release()
+    {
+        for (Block& spilled : spill_) {
+            freeBlock_(spilled);
+        }
+        spill_.clear();
+        freeBlock_(block_);
+        offset_ = 0;
+        frameBytes_ = 0;
+        highWaterMark_ = 0;
+        recentPeak_ = 0;
+        oversizedFrames_ = 0;
+    }
+
+    std::size_t FrameArena::bytesInUse() const { return frameBytes_; }
+
+    std::size_t FrameArena::capacity() const
+    {
+        std::size_t total = block_.size;
+        for (const Block& spilled : spill_) {
+            total += spilled.size;
+        }
+        return total;
+    }
+
+    std::size_t FrameArena::highWaterMark() const { return std::max(highWaterMark_, frameBytes_); }
+    std::size_t FrameArena::blockAllocations() const { return blockAllocations_; }
+
+    void* FrameArena::do_allocate(const std::size_t bytes, const std::size_t alignment)
+    {
+        Block& current = spill_.empty() ? block_ : spill_.back();
+        std::size_t start = alignUp(offset_, alignment);
+        if (current.data == nullptr || start + bytes > current.size) {
+            // Spill: grow geometrically so a frame needs few extra blocks.
+            const std::size_t size = std::max({kMinBlockSize, capacity(), alignUp(bytes + alignment, kBlockAlignment)});
+            spill_.push_back(allocateBlock_(size));
+            offset_ = 0;
+            start = alignUp(offset_, alignment);
+        }
+        Block& target = spill_.empty() ? block_ : spill_.back();
+        frameBytes_ += start - offset_ + bytes;
+        offset_ = start + bytes;
+        return target.data + start;
+    }
+
+    void FrameArena::do_deallocate(void*, std::size_t, std::size_t) {}
+
+    bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    FrameArena::Block FrameArena::allocateBlock_(const std::size_t size)
+    {
+        ++blockAllocations_;
+        return Block{
+            .data = static_cast<std::byte*>(::operator new(size, std::align_val_t{kBlockAlignment})),
+            .size = size,
+        };
+    }
+
+    void FrameArena::freeBlock_(Block& block)
+    {
+        if (block.data != nullptr) {
+            ::operator delete(block.data, std::align_val_t{kBlockAlignment});
+        }
+        block = Block{};
+    }
+
+} // namespace sim
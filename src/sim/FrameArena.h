@@ -0,0 +1,66 @@
+#ifndef PHYSICS3D_FRAMEARENA_H
+#define PHYSICS3D_FRAMEARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace sim {
+
+    // Bump allocator for step-local scratch. Deallocation is a no-op; reset() rewinds everything
+    // at once. A frame that outgrows the current block spills into extra blocks, and the next
+    // reset() replaces them with one block big enough for that frame, so a steady workload stops
+    // allocating after its first step. If the block stays far larger than recent frames need, it
+    // is shrunk, so one spike does not pin memory forever. Not thread-safe.
+    class FrameArena final : public std::pmr::memory_resource {
+    public:
+        FrameArena() = default;
+        ~FrameArena() override;
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        // Every allocation made since the last reset must be dead by now.
+        void reset();
+        // Returns all memory, like a fresh arena. Same precondition as reset().
+        void release();
+
+        [[nodiscard]] std::size_t bytesInUse() const;
+        [[nodiscard]] std::size_t capacity() const;
+        // Largest frame since construction or release(), in bytes including alignment padding.
+        [[nodiscard]] std::size_t highWaterMark() const;
+        // Blocks taken from the global heap so far; constant once the workload is steady.
+        [[nodiscard]] std::size_t blockAllocations() const;
+
+    private:
+        struct Block {
+            std::byte* data = nullptr;
+            std::size_t size = 0;
+        };
+
+        static constexpr std::size_t kBlockAlignment = 64;
+        static constexpr std::size_t kMinBlockSize = std::size_t{64} << 10;
+        // Shrink once the block has been over kShrinkRatio times every frame's need this long.
+        static constexpr std::size_t kShrinkAfterFrames = 256;
+        static constexpr std::size_t kShrinkRatio = 4;
+
+        Block block_{};
+        std::vector<Block> spill_{};
+        std::size_t offset_ = 0; // Into the last spill block if there is one, else into block_
+        std::size_t frameBytes_ = 0;
+        std::size_t highWaterMark_ = 0;
+        std::size_t recentPeak_ = 0;
+        std::size_t oversizedFrames_ = 0;
+        std::size_t blockAllocations_ = 0;
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        [[nodiscard]] Block allocateBlock_(std::size_t size);
+        static void freeBlock_(Block& block);
+    };
+
+} // namespace sim
+
+#endif // PHYSICS3D_FRAMEARENA_H
@@ -0,0 +1,305 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sim::jobs {
+    namespace {
+        struct WorkerIdentity {
+            const JobSystem* pool = nullptr;
+            std::size_t queueIndex = 0;
+        };
+
+        thread_local WorkerIdentity tlsWorker{};
+    } // namespace
+
+    void TaskGraph::clear()
+    {
+        size_ = 0;
+    }
+
+    std::size_t TaskGraph::size() const
+    {
+        return size_;
+    }
+
+    TaskGraph::Node& TaskGraph::addNode_(const std::initializer_list<NodeId> dependsOn)
+    {
+        if (size_ == nodes_.size()) {
+            nodes_.push_back(std::make_unique<Node>());
+        }
+        Node& node = *nodes_[size_];
+        node.dependencyCount = 0;
+        for (const NodeId dependency : dependsOn) {
+            if (dependency >= size_ || node.dependencyCount == kMaxDependencies) {
+                throw std::invalid_argument("TaskGraph: dependencies must be earlier nodes, at most kMaxDependencies");
+            }
+            node.dependsOn[node.dependencyCount++] = dependency;
+        }
+        ++size_;
+        return node;
+    }
+
+    TaskGraph::NodeId TaskGraph::add(
+        const std::size_t count,
+        const std::size_t grainSize,
+        RangeFn fn,
+        const std::initializer_list<NodeId> dependsOn)
+    {
+        Node& node = addNode_(dependsOn);
+        node.fn = std::move(fn);
+        node.task = nullptr;
+        node.count = count;
+        node.grain = std::max<std::size_t>(1, grainSize);
+        return size_ - 1;
+    }
+
+    TaskGraph::NodeId TaskGraph::addTask(std::function<void()> fn, const std::initializer_list<NodeId> dependsOn)
+    {
+        Node& node = addNode_(dependsOn);
+        node.fn = nullptr;
+        node.task = std::move(fn);
+        node.count = 1;
+        node.grain = 1;
+        return size_ - 1;
+    }
+
+    JobSystem::JobSystem(const int threadCount)
+    {
+        const std::size_t count = static_cast<std::size_t>(std::max(1, threadCount));
+        queues_.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        workers_.reserve(count - 1);
+        for (std::size_t i = 1; i < count; ++i) {
+            workers_.emplace_back([this, i]() { workerLoop_(i); });
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard lock(wakeMutex_);
+            stopping_ = true;
+        }
+        wakeCv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    int JobSystem::threadCount() const
+    {
+        return static_cast<int>(queues_.size());
+    }
+
+    void JobSystem::parallelFor(const std::size_t count, const std::size_t grainSize, const RangeFn& fn)
+    {
+        if (count == 0) {
+            return;
+        }
+        const std::size_t grain = std::max<std::size_t>(1, grainSize);
+        if (workers_.empty() || count <= grain) {
+            fn(0, count);
+            return;
+        }
+
+        const std::size_t self = currentQueue_();
+        Batch batch{};
+        batch.fn = &fn;
+        batch.pending.store((count + grain - 1) / grain, std::memory_order_relaxed);
+        pushChunks_(self, Task{.batch = &batch}, count, grain);
+
+        Task task{};
+        while (batch.pending.load(std::memory_order_acquire) != 0) {
+            if (popOrSteal_(self, task)) {
+                run_(task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::run(TaskGraph& graph)
+    {
+        const std::size_t nodeCount = graph.size();
+        if (workers_.empty()) {
+            for (std::size_t k = 0; k < nodeCount; ++k) {
+                const TaskGraph::Node& node = *graph.nodes_[k];
+                if (node.task) {
+                    node.task();
+                } else if (node.count > 0) {
+                    node.fn(0, node.count);
+                }
+            }
+            return;
+        }
+
+        graph.unfinished_.store(nodeCount, std::memory_order_relaxed);
+        for (std::size_t k = 0; k < nodeCount; ++k) {
+            TaskGraph::Node& node = *graph.nodes_[k];
+            node.waitingOn.store(node.dependencyCount, std::memory_order_relaxed);
+        }
+        for (std::size_t k = 0; k < nodeCount; ++k) {
+            if (graph.nodes_[k]->dependencyCount == 0) {
+                scheduleNode_(graph, k);
+            }
+        }
+
+        const std::size_t self = currentQueue_();
+        Task task{};
+        while (graph.unfinished_.load(std::memory_order_acquire) != 0) {
+            if (popOrSteal_(self, task)) {
+                run_(task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::scheduleNode_(TaskGraph& graph, const std::size_t node)
+    {
+        TaskGraph::Node& entry = *graph.nodes_[node];
+        if (entry.count == 0) {
+            finishNode_(graph, node);
+            return;
+        }
+        entry.pendingChunks.store((entry.count + entry.grain - 1) / entry.grain, std::memory_order_relaxed);
+        pushChunks_(currentQueue_(), Task{.graph = &graph, .node = node}, entry.count, entry.grain);
+    }
+
+    void JobSystem::finishNode_(TaskGraph& graph, const std::size_t node)
+    {
+        // Dependents are always later nodes, so only those need a look.
+        for (std::size_t k = node + 1; k < graph.size(); ++k) {
+            TaskGraph::Node& dependent = *graph.nodes_[k];
+            const auto first = dependent.dependsOn.begin();
+            const auto last = first + static_cast<std::ptrdiff_t>(dependent.dependencyCount);
+            if (std::find(first, last, node) != last &&
+                dependent.waitingOn.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                scheduleNode_(graph, k);
+            }
+        }
+        graph.unfinished_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void JobSystem::pushChunks_(
+        const std::size_t queueIndex,
+        const Task& prototype,
+        const std::size_t count,
+        const std::size_t grain)
+    {
+        const std::size_t chunks = (count + grain - 1) / grain;
+        {
+            std::lock_guard lock(wakeMutex_);
+            queuedTasks_.fetch_add(chunks, std::memory_order_release);
+        }
+        for (std::size_t c = 0; c < chunks; ++c) {
+            Task task = prototype;
+            task.begin = c * grain;
+            task.end = std::min(count, task.begin + grain);
+            Queue& queue = *queues_[(queueIndex + c) % queues_.size()];
+            std::lock_guard lock(queue.mutex);
+            queue.pushBack(task);
+        }
+        wakeCv_.notify_all();
+    }
+
+    std::size_t JobSystem::currentQueue_() const
+    {
+        return tlsWorker.pool == this ? tlsWorker.queueIndex : 0;
+    }
+
+    void JobSystem::workerLoop_(const std::size_t queueIndex)
+    {
+        tlsWorker = WorkerIdentity{this, queueIndex};
+        Task task{};
+        while (true) {
+            if (popOrSteal_(queueIndex, task)) {
+                run_(task);
+                continue;
+            }
+
+            std::unique_lock lock(wakeMutex_);
+            wakeCv_.wait(lock, [this]() {
+                return stopping_ || queuedTasks_.load(std::memory_order_acquire) != 0;
+            });
+            if (stopping_) {
+                return;
+            }
+        }
+    }
+
+    bool JobSystem::popOrSteal_(const std::size_t queueIndex, Task& out)
+    {
+        {
+            Queue& own = *queues_[queueIndex];
+            std::lock_guard lock(own.mutex);
+            if (own.size != 0) {
+                out = own.popBack();
+                queuedTasks_.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+
+        for (std::size_t offset = 1; offset < queues_.size(); ++offset) {
+            Queue& victim = *queues_[(queueIndex + offset) % queues_.size()];
+            std::lock_guard lock(victim.mutex);
+            if (victim.size != 0) {
+                out = victim.popFront();
+                queuedTasks_.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void JobSystem::Queue::pushBack(const Task& task)
+    {
+        if (size == ring.size()) {
+            std::vector<Task> grown(std::max<std::size_t>(16, ring.size() * 2));
+            for (std::size_t k = 0; k < size; ++k) {
+                grown[k] = ring[(head + k) % ring.size()];
+            }
+            ring.swap(grown);
+            head = 0;
+        }
+        ring[(head + size) % ring.size()] = task;
+        ++size;
+    }
+
+    JobSystem::Task JobSystem::Queue::popBack()
+    {
+        --size;
+        return ring[(head + size) % ring.size()];
+    }
+
+    JobSystem::Task JobSystem::Queue::popFront()
+    {
+        const Task task = ring[head];
+        head = (head + 1) % ring.size();
+        --size;
+        return task;
+    }
+
+    void JobSystem::run_(const Task& task)
+    {
+        if (task.batch != nullptr) {
+            (*task.batch->fn)(task.begin, task.end);
+            task.batch->pending.fetch_sub(1, std::memory_order_acq_rel);
+            return;
+        }
+
+        TaskGraph::Node& node = *task.graph->nodes_[task.node];
+        if (node.task) {
+            node.task();
+        } else {
+            node.fn(task.begin, task.end);
+        }
+        if (node.pendingChunks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            finishNode_(*task.graph, task.node);
+        }
+    }
+
+} // namespace sim::jobs
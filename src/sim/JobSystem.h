@@ -0,0 +1,126 @@
+#ifndef PHYSICS3D_JOBSYSTEM_H
+#define PHYSICS3D_JOBSYSTEM_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sim::jobs {
+
+    class JobSystem;
+
+    // Phases of work with explicit dependencies, run by JobSystem::run. Each node is a parallel
+    // for over [0, count) and starts once every node it depends on has finished; nodes without a
+    // path between them may overlap. Dependencies are added before their dependents, so
+    // insertion order is always a valid serial order. Nodes are reused across clear() calls, so
+    // rebuilding the same graph every step does not allocate.
+    class TaskGraph {
+    public:
+        using NodeId = std::size_t;
+        using RangeFn = std::function<void(std::size_t begin, std::size_t end)>;
+        static constexpr std::size_t kMaxDependencies = 4;
+
+        void clear();
+        [[nodiscard]] std::size_t size() const;
+
+        NodeId add(std::size_t count, std::size_t grainSize, RangeFn fn, std::initializer_list<NodeId> dependsOn = {});
+        // A node that runs fn once.
+        NodeId addTask(std::function<void()> fn, std::initializer_list<NodeId> dependsOn = {});
+
+    private:
+        friend class JobSystem;
+
+        struct Node {
+            RangeFn fn{};
+            std::function<void()> task{};
+            std::size_t count = 0;
+            std::size_t grain = 1;
+            std::array<NodeId, kMaxDependencies> dependsOn{};
+            std::size_t dependencyCount = 0;
+            std::atomic<std::size_t> waitingOn{0};
+            std::atomic<std::size_t> pendingChunks{0};
+        };
+
+        std::vector<std::unique_ptr<Node>> nodes_{};
+        std::size_t size_ = 0;
+        std::atomic<std::size_t> unfinished_{0};
+
+        Node& addNode_(std::initializer_list<NodeId> dependsOn);
+    };
+
+    // Small work-stealing pool. The thread calling parallelFor always participates, so a pool
+    // with threadCount == 1 owns no worker threads and runs everything inline.
+    class JobSystem {
+    public:
+        using RangeFn = std::function<void(std::size_t begin, std::size_t end)>;
+
+        explicit JobSystem(int threadCount);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        [[nodiscard]] int threadCount() const;
+
+        // Splits [0, count) into chunks of at most grainSize and blocks until every chunk ran.
+        void parallelFor(std::size_t count, std::size_t grainSize, const RangeFn& fn);
+
+        // Runs every node of the graph and blocks until all have finished. With threadCount == 1
+        // the nodes run inline in insertion order.
+        void run(TaskGraph& graph);
+
+    private:
+        struct Batch {
+            const RangeFn* fn = nullptr;
+            std::atomic<std::size_t> pending{0};
+        };
+
+        // Either a parallelFor chunk (batch) or a chunk of a graph node (graph, node).
+        struct Task {
+            Batch* batch = nullptr;
+            TaskGraph* graph = nullptr;
+            std::size_t node = 0;
+            std::size_t begin = 0;
+            std::size_t end = 0;
+        };
+
+        // Ring buffer rather than a deque: steals pop the front while the owner pushes the back,
+        // which walks a deque through a fresh block every few tasks. The ring only ever grows.
+        struct Queue {
+            std::mutex mutex;
+            std::vector<Task> ring;
+            std::size_t head = 0;
+            std::size_t size = 0;
+
+            void pushBack(const Task& task);
+            Task popBack();
+            Task popFront();
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues_{};
+        std::vector<std::thread> workers_{};
+        std::mutex wakeMutex_{};
+        std::condition_variable wakeCv_{};
+        std::atomic<std::size_t> queuedTasks_{0};
+        bool stopping_ = false;
+
+        void workerLoop_(std::size_t queueIndex);
+        [[nodiscard]] bool popOrSteal_(std::size_t queueIndex, Task& out);
+        // Queues [0, count) as chunks of prototype, spread over the queues from queueIndex on.
+        void pushChunks_(std::size_t queueIndex, const Task& prototype, std::size_t count, std::size_t grain);
+        void run_(const Task& task);
+        void scheduleNode_(TaskGraph& graph, std::size_t node);
+        void finishNode_(TaskGraph& graph, std::size_t node);
+        [[nodiscard]] std::size_t currentQueue_() const;
+    };
+
+} // namespace sim::jobs
+
+#endif // PHYSICS3D_JOBSYSTEM_H
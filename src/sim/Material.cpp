@@ -1,6 +1,8 @@
 #include "sim/Material.h"
 
-#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
 
 #include "sim/Body.h"
 
@@ -14,6 +16,39 @@ namespace sim {
                 .dynamicFriction = 0.4,
             },
         };
+
+        // Fixed storage so lookups by handle never race with registration: an entry is written
+        // before the count that publishes it.
+        struct MaterialRegistry {
+            std::array<Material, kMaxMaterials> materials{};
+            std::atomic<std::size_t> count{0};
+            std::mutex registerMutex{};
+
+            MaterialRegistry()
+            {
+                for (const Material& material : kBuiltinMaterials) {
+                    materials[count.load(std::memory_order_relaxed)] = material;
+                    count.fetch_add(1, std::memory_order_release);
+                }
+            }
+        };
+
+        MaterialRegistry& registry()
+        {
+            static MaterialRegistry instance;
+            return instance;
+        }
+
+        [[nodiscard]] MaterialHandle findIn(const MaterialRegistry& r, const std::string_view name)
+        {
+            const std::size_t count = r.count.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < count; ++i) {
+                if (r.materials[i].name == name) {
+                    return static_cast<MaterialHandle>(i);
+                }
+            }
+            return kInvalidMaterial;
+        }
     } // namespace
 
     const Material& defaultMaterial() {
@@ -40,14 +75,55 @@ namespace sim {
         return defaultMaterial();
     }
 
-    void applyMaterial(Body& body, const Material& material) {
-        body.materialName = material.name;
-        body.restitution = std::clamp(material.restitution, 0.0, 1.0);
-        body.staticFriction = std::max(0.0, material.staticFriction);
-        body.dynamicFriction = std::max(0.0, std::min(material.dynamicFriction, body.staticFriction));
+    MaterialHandle registerMaterial(const Material& material) {
+        MaterialRegistry& r = registry();
+        std::lock_guard lock(r.registerMutex);
+        if (const MaterialHandle existing = findIn(r, material.name); existing != kInvalidMaterial) {
+            const Material& known = r.materials[existing];
+            const bool same = known.restitution == material.restitution &&
+                              known.staticFriction == material.staticFriction &&
+                              known.dynamicFriction == material.dynamicFriction;
+            return same ? existing : kInvalidMaterial;
+        }
+        const std::size_t count = r.count.load(std::memory_order_relaxed);
+        if (count >= kMaxMaterials) {
+            return kInvalidMaterial;
+        }
+        r.materials[count] = material;
+        r.count.store(count + 1, std::memory_order_release);
+        return static_cast<MaterialHandle>(count);
+    }
+
+    MaterialHandle findMaterial(const std::string_view name) {
+        return findIn(registry(), name);
+    }
+
+    std::size_t materialCount() {
+        return registry().count.load(std::memory_order_acquire);
+    }
+
+    bool isValidMaterial(const MaterialHandle handle) {
+        return handle < materialCount();
+    }
+
+    const Material& materialFor(const MaterialHandle handle) {
+        return isValidMaterial(handle) ? registry().materials[handle] : registry().materials[kDefaultMaterial];
+    }
+
+    std::string_view materialName(const MaterialHandle handle) {
+        return materialFor(handle).name;
+    }
+
+    MaterialHandle applyMaterial(Body& body, const Material& material) {
+        const MaterialHandle handle = registerMaterial(material);
+        if (handle != kInvalidMaterial) {
+            body.material = handle;
+        }
+        return handle;
     }
 
     void assignMaterial(Body& body, const std::string_view name) {
-        applyMaterial(body, resolveMaterial(name));
+        const MaterialHandle handle = findMaterial(name);
+        body.material = handle != kInvalidMaterial ? handle : kDefaultMaterial;
     }
 } // namespace sim
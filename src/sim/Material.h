@@ -1,9 +1,12 @@
 #ifndef PHYSICS3D_MATERIAL_H
 #define PHYSICS3D_MATERIAL_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <vector>
+#include "Real.h"
 
 namespace sim {
     class Body;
@@ -12,17 +15,38 @@ namespace sim {
 
     struct Material {
         std::string name;
-        double restitution = 0.5;
-        double staticFriction = 0.6;
-        double dynamicFriction = 0.4;
+        Real restitution = 0.5;
+        Real staticFriction = 0.6;
+        Real dynamicFriction = 0.4;
     };
 
+    // Index into the process-wide material registry. Materials are never removed or changed
+    // once registered, so a handle (and the name view it resolves to) stays valid for the life
+    // of the program.
+    using MaterialHandle = std::uint16_t;
+    inline constexpr MaterialHandle kDefaultMaterial = 0;
+    inline constexpr MaterialHandle kInvalidMaterial = 0xffff;
+    inline constexpr std::size_t kMaxMaterials = 256;
+
     [[nodiscard]] const Material& defaultMaterial();
     [[nodiscard]] const std::vector<Material>& builtinMaterials();
     [[nodiscard]] const Material* findBuiltinMaterial(std::string_view name);
     [[nodiscard]] const Material& resolveMaterial(std::string_view name);
 
-    void applyMaterial(Body& body, const Material& material);
+    // Interns material by name. Registering an identical definition again returns its existing
+    // handle; returns kInvalidMaterial if the name is already registered with other coefficients
+    // or the registry is full. Safe to call from any thread.
+    [[nodiscard]] MaterialHandle registerMaterial(const Material& material);
+    [[nodiscard]] MaterialHandle findMaterial(std::string_view name);
+    [[nodiscard]] std::size_t materialCount();
+    [[nodiscard]] bool isValidMaterial(MaterialHandle handle);
+    // Invalid handles resolve to the default material.
+    [[nodiscard]] const Material& materialFor(MaterialHandle handle);
+    [[nodiscard]] std::string_view materialName(MaterialHandle handle);
+
+    // Registers material and points body at it. On failure (see registerMaterial) the body keeps
+    // its material and kInvalidMaterial is returned.
+    MaterialHandle applyMaterial(Body& body, const Material& material);
     void assignMaterial(Body& body, std::string_view name);
 } // namespace sim
 
@@ -0,0 +1,176 @@
+#include "Parareal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace sim {
+    namespace {
+        // The components of fine + (coarse - previousCoarse), with every quaternion first moved
+        // to the hemisphere of fine so that q and -q do not cancel.
+        [[nodiscard]] Quaternion correctOrientation(const Quaternion& fine, Quaternion coarse, Quaternion previousCoarse)
+        {
+            const auto align = [&fine](Quaternion& q) {
+                if (quatDot(fine, q) < Real(0.0)) {
+                    q = {-q.w, -q.x, -q.y, -q.z};
+                }
+            };
+            align(coarse);
+            align(previousCoarse);
+            Quaternion result{
+                fine.w + (coarse.w - previousCoarse.w),
+                fine.x + (coarse.x - previousCoarse.x),
+                fine.y + (coarse.y - previousCoarse.y),
+                fine.z + (coarse.z - previousCoarse.z),
+            };
+            normalizeQuat(result);
+            return result;
+        }
+    } // namespace
+
+    Parareal::Parareal()
+        : Parareal(Params{})
+    {
+    }
+
+    Parareal::Parareal(const Params& params)
+        : params_(params)
+        , jobs_(std::make_unique<jobs::JobSystem>(std::clamp(params.workerThreads, 1, World::Params::kMaxWorkerThreads)))
+    {
+    }
+
+    const Parareal::Params& Parareal::params() const { return params_; }
+
+    void Parareal::propagate_(World& world, const Motion* in, Motion* out, const int steps, const Real dt)
+    {
+        std::vector<Body>& bodies = world.bodies();
+        for (std::size_t i = 0; i < bodies.size(); ++i) {
+            Body& body = bodies[i];
+            body.position = in[i].position;
+            body.velocity = in[i].velocity;
+            body.angularVelocity = in[i].angularVelocity;
+            body.orientation = in[i].orientation;
+            body.sleeping = false;
+            body.sleepTimer = 0.0;
+        }
+        world.advance(steps, dt);
+        const std::vector<Body>& stepped = std::as_const(world).bodies();
+        for (std::size_t i = 0; i < stepped.size(); ++i) {
+            out[i] = Motion{stepped[i].position, stepped[i].velocity, stepped[i].angularVelocity, stepped[i].orientation};
+        }
+    }
+
+    Parareal::Stats Parareal::advance(World& world, const int steps, const Real dt)
+    {
+        Stats stats{};
+        if (steps <= 0) {
+            return stats;
+        }
+        const int slices = std::clamp(params_.slices, 1, steps);
+        const int maxIterations = params_.maxIterations > 0 ? std::min(params_.maxIterations, slices) : slices;
+        const int coarseSteps = std::max(1, params_.coarseStepsPerSlice);
+        stats.slices = slices;
+
+        World::Params fineParams = world.params();
+        fineParams.workerThreads = 1;
+        fineParams.enableSleeping = false;
+        fineParams.reorderInterval = 0;
+        World::Params coarseParams = fineParams;
+        coarseParams.enableCollisions = false;
+        coarseParams.smallStepSolver = false;
+        coarseParams.adaptiveSubsteps = false;
+        coarseParams.maxSubsteps = 1;
+        coarseParams.maxSubstepDt = std::abs(steps * dt);
+
+        const std::vector<Body>& initial = std::as_const(world).bodies();
+        const std::size_t count = initial.size();
+        World coarseWorld(initial, coarseParams);
+        boundaries_.resize((static_cast<std::size_t>(slices) + 1) * count);
+        fine_.resize(static_cast<std::size_t>(slices) * count);
+        coarse_.resize(static_cast<std::size_t>(slices) * count);
+        predicted_.resize(count);
+
+        // Whole fine steps per slice, the remainder spread over the first slices.
+        const auto sliceSteps = [steps, slices](const int n) { return steps / slices + (n < steps % slices ? 1 : 0); };
+        const auto boundary = [this, count](const int n) { return boundaries_.data() + static_cast<std::size_t>(n) * count; };
+        const auto coarseOf = [this, count](const int n) { return coarse_.data() + static_cast<std::size_t>(n) * count; };
+        const auto fineOf = [this, count](const int n) { return fine_.data() + static_cast<std::size_t>(n) * count; };
+        const auto propagateCoarse = [&](const int n, Motion* out) {
+            propagate_(coarseWorld, boundary(n), out, coarseSteps, sliceSteps(n) * dt / coarseSteps);
+            stats.coarseSteps += static_cast<std::uint64_t>(coarseSteps);
+        };
+
+        for (std::size_t i = 0; i < count; ++i) {
+            boundary(0)[i] = Motion{initial[i].position, initial[i].velocity, initial[i].angularVelocity, initial[i].orientation};
+        }
+        for (int n = 0; n < slices; ++n) {
+            propagateCoarse(n, coarseOf(n));
+            std::copy_n(coarseOf(n), count, boundary(n + 1));
+        }
+
+        for (int k = 1; k <= maxIterations; ++k) {
+            // Slices before k - 1 start from exact boundaries that did not change; their fine
+            // results from earlier iterations still hold.
+            const int first = k - 1;
+            jobs_->parallelFor(static_cast<std::size_t>(slices - first), 1,
+                [first, dt, &initial, &fineParams, &sliceSteps, &boundary, &fineOf](std::size_t begin, std::size_t end) {
+                    for (std::size_t s = begin; s < end; ++s) {
+                        const int n = first + static_cast<int>(s);
+                        // A fresh world per run: a reused one would carry contact manifolds and
+                        // other step state over from a different start.
+                        World fineWorld(initial, fineParams);
+                        propagate_(fineWorld, boundary(n), fineOf(n), sliceSteps(n), dt);
+                    }
+                });
+            for (int n = first; n < slices; ++n) {
+                stats.fineSteps += static_cast<std::uint64_t>(sliceSteps(n));
+            }
+            stats.criticalPathFineSteps += static_cast<std::uint64_t>(sliceSteps(first));
+
+            Real correction = 0.0;
+            for (int n = first; n < slices; ++n) {
+                propagateCoarse(n, predicted_.data());
+                const Motion* fine = fineOf(n);
+                Motion* previousCoarse = coarseOf(n);
+                Motion* next = boundary(n + 1);
+                for (std::size_t i = 0; i < count; ++i) {
+                    const Motion& coarse = predicted_[i];
+                    const Motion& prev = previousCoarse[i];
+                    Motion corrected{
+                        fine[i].position + (coarse.position - prev.position),
+                        fine[i].velocity + (coarse.velocity - prev.velocity),
+                        fine[i].angularVelocity + (coarse.angularVelocity - prev.angularVelocity),
+                        correctOrientation(fine[i].orientation, coarse.orientation, prev.orientation),
+                    };
+                    correction = std::max(correction, (corrected.position - next[i].position).magnitude() / initial[i].radius);
+                    next[i] = corrected;
+                }
+                std::copy_n(predicted_.data(), count, previousCoarse);
+            }
+            stats.iterations = k;
+            stats.correction = correction;
+            if (correction <= params_.tolerance) {
+                stats.converged = true;
+                break;
+            }
+        }
+        stats.converged = stats.converged || stats.iterations == slices;
+
+        std::vector<Body>& bodies = world.bodies();
+        const Motion* last = boundary(slices);
+        for (std::size_t i = 0; i < count; ++i) {
+            Body& body = bodies[i];
+            body.position = last[i].position;
+            body.velocity = last[i].velocity;
+            body.angularVelocity = last[i].angularVelocity;
+            body.orientation = last[i].orientation;
+            body.prevPosition = body.position;
+            body.prevOrientation = body.orientation;
+            // Every body moved awake in the propagators; the world re-evaluates sleep from here.
+            body.sleeping = false;
+            body.sleepTimer = 0.0;
+        }
+        return stats;
+    }
+
+} // namespace sim
@@ -0,0 +1,87 @@
+#ifndef PHYSICS3D_PARAREAL_H
+#define PHYSICS3D_PARAREAL_H
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "JobSystem.h"
+#include "World.h"
+
+namespace sim {
+
+    // Parallel-in-time stepping for long, smooth runs such as collision-free orbits. The run is cut
+    // into slices. A coarse propagator (a few large leapfrog steps per slice, no collisions, no CCD)
+    // sweeps them serially. The fine propagator, the world's own stepper at the caller's dt,
+    // refines every slice in parallel from the coarse guess of its start. Each iteration corrects
+    // slice n + 1 by the fine result of slice n minus the coarse one from the previous iteration,
+    // and stops once no slice boundary moved more than tolerance body radii. After k iterations
+    // the first k slices match serial stepping exactly, so the worst case is as slow as serial
+    // stepping plus overhead; the speedup comes from converging in few iterations.
+    //
+    // Every fine run starts in a fresh world, so contact manifolds and other step state never
+    // leak from one run into another. The same goes for serial stepping's state, though: with
+    // contacts, warm starting restarts at every slice boundary, and "exactly" above becomes
+    // "closely". Sleeping and Morton reordering are off in both propagators, since slices must
+    // map body i to body i. Contacts and anything else discontinuous usually keep Parareal from
+    // converging before that worst case.
+    class Parareal {
+    public:
+        struct Params {
+            static constexpr int kDefaultSlices = 8;
+            static constexpr int kDefaultCoarseStepsPerSlice = 4;
+            // Single precision rounds positions tens of radii from the origin at about 1e-6 radii.
+            static constexpr Real kDefaultTolerance = std::is_same_v<Real, float> ? 1e-4 : 1e-6;
+
+            int slices = kDefaultSlices;
+            int coarseStepsPerSlice = kDefaultCoarseStepsPerSlice;
+            int maxIterations = 0; // 0 means slices, after which the result is exact
+            Real tolerance = kDefaultTolerance; // In radii of the body that moved most
+            int workerThreads = 1; // Including the caller; fine slices run in parallel
+        };
+
+        struct Stats {
+            int slices = 0;
+            int iterations = 0;
+            bool converged = false;
+            Real correction = 0.0; // Of the last iteration, in body radii
+            std::uint64_t fineSteps = 0;
+            std::uint64_t coarseSteps = 0;
+            // Fine steps one after another: the longest slice refined per iteration. With enough
+            // threads the run takes about as long as this many serial steps plus the coarse sweeps.
+            std::uint64_t criticalPathFineSteps = 0;
+        };
+
+        Parareal();
+        explicit Parareal(const Params& params);
+
+        // Moves world steps * dt ahead, approximating world.advance(steps, dt). Only motion is
+        // written back (position, velocity, orientation, angular velocity); prevPosition and
+        // prevOrientation are set to the final state, since there is no last step to interpolate.
+        // Every body is left awake.
+        Stats advance(World& world, int steps, Real dt);
+
+        [[nodiscard]] const Params& params() const;
+
+    private:
+        struct Motion {
+            Vec3 position{};
+            Vec3 velocity{};
+            Vec3 angularVelocity{};
+            Quaternion orientation{};
+        };
+
+        Params params_{};
+        std::unique_ptr<jobs::JobSystem> jobs_{};
+        std::vector<Motion> boundaries_{}; // (slices + 1) x bodies
+        std::vector<Motion> fine_{}; // slices x bodies
+        std::vector<Motion> coarse_{}; // slices x bodies, from the previous iteration
+        std::vector<Motion> predicted_{}; // bodies
+
+        static void propagate_(World& world, const Motion* in, Motion* out, int steps, Real dt);
+    };
+
+} // namespace sim
+
+#endif // PHYSICS3D_PARAREAL_H
@@ -6,10 +6,10 @@
 
 namespace sim {
     struct Quaternion {
-        double w = 1.0;
-        double x = 0.0;
-        double y = 0.0;
-        double z = 0.0;
+        Real w = 1.0;
+        Real x = 0.0;
+        Real y = 0.0;
+        Real z = 0.0;
     };
 
     [[nodiscard]] inline Quaternion quatMultiply(const Quaternion& a, const Quaternion& b) {
@@ -22,34 +22,34 @@ namespace sim {
     }
 
     inline void normalizeQuat(Quaternion& q) {
-        const double n2 = q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z;
-        if (n2 <= 0.0) {
+        const Real n2 = q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z;
+        if (n2 <= Real(0.0)) {
             q = {};
             return;
         }
-        const double invN = 1.0 / std::sqrt(n2);
+        const Real invN = Real(1.0) / std::sqrt(n2);
         q.w *= invN;
         q.x *= invN;
         q.y *= invN;
         q.z *= invN;
     }
 
-    inline void integrateOrientation(Quaternion& q, const Vec3& angularVelocity, const double dt) {
+    inline void integrateOrientation(Quaternion& q, const Vec3& angularVelocity, const Real dt) {
         const Quaternion omegaQ{0.0, angularVelocity.x, angularVelocity.y, angularVelocity.z};
         const Quaternion dq = quatMultiply(omegaQ, q);
-        q.w += 0.5 * dt * dq.w;
-        q.x += 0.5 * dt * dq.x;
-        q.y += 0.5 * dt * dq.y;
-        q.z += 0.5 * dt * dq.z;
+        q.w += Real(0.5) * dt * dq.w;
+        q.x += Real(0.5) * dt * dq.x;
+        q.y += Real(0.5) * dt * dq.y;
+        q.z += Real(0.5) * dt * dq.z;
         normalizeQuat(q);
     }
 
-    [[nodiscard]] inline double quatDot(const Quaternion& a, const Quaternion& b) {
+    [[nodiscard]] inline Real quatDot(const Quaternion& a, const Quaternion& b) {
         return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
     }
 
-    [[nodiscard]] inline Quaternion nlerpQuat(const Quaternion &a, Quaternion b, const double t) {
-        if (quatDot(a, b) < 0.0) {
+    [[nodiscard]] inline Quaternion nlerpQuat(const Quaternion &a, Quaternion b, const Real t) {
+        if (quatDot(a, b) < Real(0.0)) {
             b.w = -b.w;
             b.x = -b.x;
             b.y = -b.y;
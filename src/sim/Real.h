@@ -0,0 +1,17 @@
+#ifndef PHYSICS3D_REAL_H
+#define PHYSICS3D_REAL_H
+
+namespace sim {
+
+    // Scalar type of the whole sim core. Double by default; define PHYSICS3D_SIM_SINGLE_PRECISION
+    // for a float build, which halves the size of every hot array and doubles the SIMD width.
+    // The choice is global: mixing objects built with either setting is an ODR violation.
+#ifdef PHYSICS3D_SIM_SINGLE_PRECISION
+    using Real = float;
+#else
+    using Real = double;
+#endif
+
+} // namespace sim
+
+#endif // PHYSICS3D_REAL_H
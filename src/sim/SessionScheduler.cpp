@@ -0,0 +1,254 @@
+#include "SessionScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace sim {
+    namespace {
+        // Consecutive late ticks before a session is degraded, so one hiccup does not count.
+        constexpr int kLateTicksBeforeDegrade = 2;
+        // Weight of the newest sample in smoothed costs and latencies.
+        constexpr double kSmoothing = 0.2;
+
+        [[nodiscard]] double sanitizeSpeed(const double simSpeed)
+        {
+            return std::isfinite(simSpeed) ? std::max<double>(0.0, simSpeed) : 0.0;
+        }
+
+        [[nodiscard]] double smooth(const double average, const double sample)
+        {
+            return average > 0.0 ? (1.0 - kSmoothing) * average + kSmoothing * sample : sample;
+        }
+
+        [[nodiscard]] double secondsSince(const std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    } // namespace
+
+    SessionScheduler::SessionScheduler()
+        : SessionScheduler(Params{})
+    {
+    }
+
+    SessionScheduler::SessionScheduler(const Params& params)
+        : params_(params)
+        , jobs_(std::make_unique<jobs::JobSystem>(std::clamp(params.workerThreads, 1, World::Params::kMaxWorkerThreads)))
+    {
+        if (!(params_.stepDt > Real(0.0)) || !std::isfinite(params_.stepDt)) {
+            params_.stepDt = Params::kDefaultStepDt;
+        }
+        params_.maxStepsPerTick = std::max(1, params_.maxStepsPerTick);
+        params_.recoverTicks = std::max(1, params_.recoverTicks);
+    }
+
+    SessionScheduler::SessionId SessionScheduler::addSession(World world, const double simSpeed, const double now)
+    {
+        auto session = std::make_unique<Session>(Session{.id = nextId_++, .world = std::move(world)});
+        session->simSpeed = sanitizeSpeed(simSpeed);
+        session->lastTime = now;
+        // Sessions share the scheduler's pool; a pool per world would oversubscribe the cores.
+        session->world.params().workerThreads = 1;
+        indexOf_.emplace(session->id, sessions_.size());
+        sessions_.push_back(std::move(session));
+        return sessions_.back()->id;
+    }
+
+    bool SessionScheduler::removeSession(const SessionId id)
+    {
+        const auto found = indexOf_.find(id);
+        if (found == indexOf_.end()) {
+            return false;
+        }
+        const std::size_t index = found->second;
+        indexOf_.erase(found);
+        if (index + 1 != sessions_.size()) {
+            sessions_[index] = std::move(sessions_.back());
+            indexOf_[sessions_[index]->id] = index;
+        }
+        sessions_.pop_back();
+        return true;
+    }
+
+    bool SessionScheduler::contains(const SessionId id) const { return indexOf_.contains(id); }
+    std::size_t SessionScheduler::size() const { return sessions_.size(); }
+
+    void SessionScheduler::setSimSpeed(const SessionId id, const double simSpeed)
+    {
+        session_(id).simSpeed = sanitizeSpeed(simSpeed);
+    }
+
+    World& SessionScheduler::world(const SessionId id) { return session_(id).world; }
+    const World& SessionScheduler::world(const SessionId id) const { return session_(id).world; }
+    const SessionScheduler::SessionMetrics& SessionScheduler::metrics(const SessionId id) const
+    {
+        return session_(id).metrics;
+    }
+    const SessionScheduler::Params& SessionScheduler::params() const { return params_; }
+
+    SessionScheduler::Session& SessionScheduler::session_(const SessionId id)
+    {
+        return *sessions_[indexOf_.at(id)];
+    }
+
+    const SessionScheduler::Session& SessionScheduler::session_(const SessionId id) const
+    {
+        return *sessions_[indexOf_.at(id)];
+    }
+
+    SessionScheduler::TickStats SessionScheduler::tick(const double now)
+    {
+        TickStats stats{};
+        stats.sessions = sessions_.size();
+        if (sessions_.empty()) {
+            return stats;
+        }
+        const auto tickStart = std::chrono::steady_clock::now();
+        const double stepDt = params_.stepDt;
+
+        byUrgency_.clear();
+        for (const auto& owned : sessions_) {
+            Session& session = *owned;
+            const double elapsed = std::isfinite(now - session.lastTime) ? std::max<double>(0.0, now - session.lastTime) : 0.0;
+            session.lastTime = now;
+            session.owed += elapsed * session.simSpeed;
+            // Below the last level, degrading is still expected to catch the session up.
+            const double maxOwed = std::max<double>(stepDt, params_.maxLag * session.simSpeed);
+            if (session.metrics.degradeLevel == Params::kMaxDegradeLevel && session.owed > maxOwed) {
+                session.metrics.droppedSimTime += session.owed - maxOwed;
+                session.owed = maxOwed;
+            }
+            session.dueSteps = static_cast<int>(std::min<double>(std::floor(session.owed / stepDt), params_.maxStepsPerTick));
+            session.allowedSteps = session.dueSteps;
+            session.ranSteps = 0;
+            byUrgency_.push_back(&session);
+        }
+        // Furthest behind in wall-clock terms first; ids keep the order stable.
+        std::sort(byUrgency_.begin(), byUrgency_.end(), [](const Session* a, const Session* b) {
+            const double lagA = a->simSpeed > 0.0 ? a->owed / a->simSpeed : 0.0;
+            const double lagB = b->simSpeed > 0.0 ? b->owed / b->simSpeed : 0.0;
+            return lagA != lagB ? lagA > lagB : a->id < b->id;
+        });
+        shareBudget_();
+
+        // Every thread claims the most urgent session nobody has taken yet.
+        nextSession_.store(0, std::memory_order_relaxed);
+        const auto threads = static_cast<std::size_t>(jobs_->threadCount());
+        jobs_->parallelFor(threads, 1, [this, tickStart](std::size_t, std::size_t) {
+            for (std::size_t k = nextSession_.fetch_add(1, std::memory_order_relaxed); k < byUrgency_.size();
+                 k = nextSession_.fetch_add(1, std::memory_order_relaxed)) {
+                serve_(*byUrgency_[k], tickStart);
+            }
+        });
+
+        for (const auto& owned : sessions_) {
+            Session& session = *owned;
+            SessionMetrics& metrics = session.metrics;
+            metrics.lag = session.simSpeed > 0.0 ? session.owed / session.simSpeed : 0.0;
+            const bool served = session.ranSteps > 0;
+            const bool late = served && (session.ranSteps < session.dueSteps || metrics.lastLatency > params_.frameBudget);
+            updateDegradeLevel_(session, late);
+            stats.servedSessions += served ? 1 : 0;
+            stats.lateSessions += late ? 1 : 0;
+            stats.degradedSessions += metrics.degradeLevel > 0 ? 1 : 0;
+            stats.steps += static_cast<std::uint64_t>(session.ranSteps);
+        }
+        stats.wallSeconds = secondsSince(tickStart);
+        return stats;
+    }
+
+    void SessionScheduler::shareBudget_()
+    {
+        // Max-min fair: visiting sessions by ascending demand, each gets the smaller of what it
+        // needs and an even split of what is left. One session never gets more than the whole
+        // frame, since it runs on one thread. Sessions whose cost is not known yet get all their
+        // steps.
+        byDemand_.clear();
+        for (Session* session : byUrgency_) {
+            if (session->dueSteps > 0 && session->metrics.wallCostPerStep > 0.0) {
+                byDemand_.push_back(session);
+            }
+        }
+        std::sort(byDemand_.begin(), byDemand_.end(), [](const Session* a, const Session* b) {
+            return a->dueSteps * a->metrics.wallCostPerStep < b->dueSteps * b->metrics.wallCostPerStep;
+        });
+        double remaining = params_.frameBudget * jobs_->threadCount();
+        for (std::size_t k = 0; k < byDemand_.size(); ++k) {
+            Session& session = *byDemand_[k];
+            const double cost = session.metrics.wallCostPerStep;
+            const double share = remaining / static_cast<double>(byDemand_.size() - k);
+            const double allowance = std::min({session.dueSteps * cost, share, params_.frameBudget});
+            remaining -= allowance;
+            // At least one step, so no session ever stands still.
+            const double affordable = std::floor(allowance / cost + 1e-9);
+            session.allowedSteps = static_cast<int>(std::clamp<double>(affordable, 1.0, session.dueSteps));
+        }
+    }
+
+    void SessionScheduler::serve_(Session& session, const std::chrono::steady_clock::time_point tickStart)
+    {
+        if (session.allowedSteps <= 0) {
+            return;
+        }
+        // Estimates can be wrong; a session reached after the deadline still moves, but only by
+        // one step.
+        const int steps = secondsSince(tickStart) > params_.frameBudget ? 1 : session.allowedSteps;
+        session.world.params().workerThreads = 1;
+        const auto start = std::chrono::steady_clock::now();
+        session.world.advance(steps, params_.stepDt);
+        const double wallTime = secondsSince(start);
+
+        SessionMetrics& metrics = session.metrics;
+        session.owed = std::max<double>(0.0, session.owed - steps * static_cast<double>(params_.stepDt));
+        session.ranSteps = steps;
+        metrics.steps += static_cast<std::uint64_t>(steps);
+        metrics.wallCostPerStep = smooth(metrics.wallCostPerStep, wallTime / steps);
+        metrics.lastLatency = secondsSince(tickStart);
+        metrics.meanLatency = smooth(metrics.meanLatency, metrics.lastLatency);
+        metrics.maxLatency = std::max(metrics.maxLatency, metrics.lastLatency);
+    }
+
+    void SessionScheduler::updateDegradeLevel_(Session& session, const bool late)
+    {
+        const int level = session.metrics.degradeLevel;
+        if (late) {
+            ++session.metrics.deadlineMisses;
+            session.onTimeTicks = 0;
+            if (++session.lateTicks >= kLateTicksBeforeDegrade && level < Params::kMaxDegradeLevel) {
+                applyDegradeLevel_(session, level + 1);
+                session.lateTicks = 0;
+            }
+            return;
+        }
+        session.lateTicks = 0;
+        if (level > 0 && ++session.onTimeTicks >= params_.recoverTicks) {
+            applyDegradeLevel_(session, level - 1);
+            session.onTimeTicks = 0;
+        }
+    }
+
+    void SessionScheduler::applyDegradeLevel_(Session& session, const int level)
+    {
+        World::Params& worldParams = session.world.params();
+        if (session.metrics.degradeLevel == 0) {
+            session.baseMaxSubsteps = worldParams.maxSubsteps;
+            session.baseMaxCcdIterations = worldParams.maxCcdIterationsPerStep;
+            session.baseSmallSteps = worldParams.smallSteps;
+        }
+        if (level == 0) {
+            worldParams.maxSubsteps = session.baseMaxSubsteps;
+            worldParams.maxCcdIterationsPerStep = session.baseMaxCcdIterations;
+            worldParams.smallSteps = session.baseSmallSteps;
+        } else {
+            const int substeps = std::clamp(session.baseMaxSubsteps, 1, World::Params::kDefaultMaxSubsteps);
+            const int smallSteps = std::clamp(session.baseSmallSteps, 1, World::Params::kMaxSmallSteps);
+            worldParams.maxSubsteps = std::max(1, substeps >> level);
+            worldParams.maxCcdIterationsPerStep = std::max(1, std::max(1, session.baseMaxCcdIterations) >> (2 * level));
+            worldParams.smallSteps = std::max(1, smallSteps >> level);
+        }
+        session.metrics.degradeLevel = level;
+    }
+
+} // namespace sim
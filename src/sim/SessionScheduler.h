@@ -0,0 +1,127 @@
+#ifndef PHYSICS3D_SESSIONSCHEDULER_H
+#define PHYSICS3D_SESSIONSCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "JobSystem.h"
+#include "World.h"
+
+namespace sim {
+
+    // Steps the worlds of many interactive sessions on one shared pool, each at its own simSpeed
+    // and against a wall-clock deadline: whatever a session owes at tick(now) should be stepped
+    // within frameBudget. The caller supplies now (any monotonic clock in seconds, as long as it
+    // is the same one for every call); step costs and latencies are measured on a steady clock.
+    //
+    // Sessions furthest behind are served first. When the pool cannot cover every session's
+    // debt, the budget is shared max-min fairly: sessions that need less than an even share get
+    // all they need, the rest split what is left, so one heavy session never takes time from
+    // light ones. A session that keeps missing its deadline is degraded one level at a time, each
+    // halving maxSubsteps and smallSteps and quartering maxCcdIterationsPerStep; past the last
+    // level, the time it cannot catch up on within maxLag is dropped. After recoverTicks ticks on
+    // time it climbs back a level, and at level 0 its own settings are restored. While a session
+    // is degraded, the scheduler owns those three fields of its params.
+    class SessionScheduler {
+    public:
+        using SessionId = std::uint64_t;
+
+        struct Params {
+            static constexpr double kDefaultFrameBudget = 1.0 / 60.0;
+            static constexpr Real kDefaultStepDt = 1.0 / 60.0;
+            static constexpr double kDefaultMaxLag = 0.25;
+            static constexpr int kDefaultRecoverTicks = 30;
+            static constexpr int kDefaultMaxStepsPerTick = 64;
+            static constexpr int kMaxDegradeLevel = 3;
+
+            int workerThreads = 1; // Including the thread calling tick()
+            double frameBudget = kDefaultFrameBudget; // Wall-clock seconds a tick may take
+            Real stepDt = kDefaultStepDt;
+            double maxLag = kDefaultMaxLag; // Most wall-clock seconds a session at the last degrade level may fall behind
+            int recoverTicks = kDefaultRecoverTicks;
+            int maxStepsPerTick = kDefaultMaxStepsPerTick;
+        };
+
+        struct SessionMetrics {
+            double lastLatency = 0.0; // From the start of the tick to this session's steps being done
+            double meanLatency = 0.0; // Smoothed
+            double maxLatency = 0.0;
+            double lag = 0.0; // Wall-clock seconds of simulated time still owed after the tick
+            double wallCostPerStep = 0.0; // Smoothed
+            double droppedSimTime = 0.0; // Given up for good at the last degrade level, over the session's lifetime
+            std::uint64_t steps = 0;
+            std::uint64_t deadlineMisses = 0; // Ticks that ended with steps owed or past frameBudget
+            int degradeLevel = 0;
+        };
+
+        // Totals over one tick() call.
+        struct TickStats {
+            std::size_t sessions = 0;
+            std::size_t servedSessions = 0;
+            std::size_t lateSessions = 0;
+            std::size_t degradedSessions = 0;
+            std::uint64_t steps = 0;
+            double wallSeconds = 0.0;
+        };
+
+        SessionScheduler();
+        explicit SessionScheduler(const Params& params);
+
+        // The session starts owing nothing at now.
+        SessionId addSession(World world, double simSpeed, double now);
+        bool removeSession(SessionId id);
+        [[nodiscard]] bool contains(SessionId id) const;
+        [[nodiscard]] std::size_t size() const;
+
+        void setSimSpeed(SessionId id, double simSpeed);
+        [[nodiscard]] World& world(SessionId id);
+        [[nodiscard]] const World& world(SessionId id) const;
+        [[nodiscard]] const SessionMetrics& metrics(SessionId id) const;
+        [[nodiscard]] const Params& params() const;
+
+        TickStats tick(double now);
+
+    private:
+        struct Session {
+            SessionId id = 0;
+            World world;
+            double simSpeed = 1.0;
+            double owed = 0.0; // Simulated seconds
+            double lastTime = 0.0;
+            int onTimeTicks = 0;
+            int lateTicks = 0;
+            int baseMaxSubsteps = 0; // Own settings, kept while degraded
+            int baseMaxCcdIterations = 0;
+            int baseSmallSteps = 0;
+            // Per tick.
+            int dueSteps = 0;
+            int allowedSteps = 0;
+            int ranSteps = 0;
+            SessionMetrics metrics{};
+        };
+
+        Params params_{};
+        std::vector<std::unique_ptr<Session>> sessions_{};
+        std::unordered_map<SessionId, std::size_t> indexOf_{};
+        SessionId nextId_ = 1;
+        std::unique_ptr<jobs::JobSystem> jobs_{};
+        std::vector<Session*> byUrgency_{};
+        std::vector<Session*> byDemand_{};
+        std::atomic<std::size_t> nextSession_{0};
+
+        [[nodiscard]] Session& session_(SessionId id);
+        [[nodiscard]] const Session& session_(SessionId id) const;
+        void shareBudget_();
+        void serve_(Session& session, std::chrono::steady_clock::time_point tickStart);
+        void updateDegradeLevel_(Session& session, bool late);
+        static void applyDegradeLevel_(Session& session, int level);
+    };
+
+} // namespace sim
+
+#endif // PHYSICS3D_SESSIONSCHEDULER_H
@@ -0,0 +1,56 @@
+#ifndef PHYSICS3D_TRIPLEBUFFER_H
+#define PHYSICS3D_TRIPLEBUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace sim {
+
+    // Lock-free hand-off of the latest value from one writer thread to one reader thread. The
+    // writer fills back() and publishes it; the reader acquires the most recent publication and
+    // reads front() until its next acquire. Neither side ever waits, and values published
+    // between two acquires are skipped. The three slots are reused, so a writer that assigns
+    // into back() stops allocating once every slot has seen the largest value.
+    template <typename T>
+    class TripleBuffer {
+    public:
+        TripleBuffer() = default;
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        // Writer side. back() holds some older value, never the one just published.
+        [[nodiscard]] T& back() { return slots_[back_]; }
+
+        void publish()
+        {
+            const std::uint8_t published = static_cast<std::uint8_t>(back_ | kFresh);
+            back_ = static_cast<std::uint8_t>(middle_.exchange(published, std::memory_order_acq_rel) & kIndexMask);
+        }
+
+        // Reader side. Returns false, keeping front() as it was, if nothing was published since
+        // the last acquire.
+        bool acquire()
+        {
+            if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) {
+                return false;
+            }
+            front_ = static_cast<std::uint8_t>(middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask);
+            return true;
+        }
+
+        [[nodiscard]] const T& front() const { return slots_[front_]; }
+
+    private:
+        static constexpr std::uint8_t kIndexMask = 0x3;
+        static constexpr std::uint8_t kFresh = 0x4;
+
+        std::array<T, 3> slots_{};
+        std::uint8_t back_ = 0;
+        std::uint8_t front_ = 1;
+        std::atomic<std::uint8_t> middle_{2};
+    };
+
+} // namespace sim
+
+#endif // PHYSICS3D_TRIPLEBUFFER_H
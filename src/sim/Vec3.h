@@ -2,15 +2,16 @@
 #define PHYSICS3D_VEC3_H
 
 #include <cmath>
+#include "Real.h"
 
 namespace sim {
     struct Vec3 {
-        double x = 0.0;
-        double y = 0.0;
-        double z = 0.0;
+        Real x = 0.0;
+        Real y = 0.0;
+        Real z = 0.0;
 
         constexpr Vec3() = default;
-        constexpr Vec3(const double xIn, const double yIn, const double zIn)
+        constexpr Vec3(const Real xIn, const Real yIn, const Real zIn)
             : x(xIn), y(yIn), z(zIn) {}
 
         [[nodiscard]] constexpr Vec3 operator+(const Vec3& o) const {
@@ -21,11 +22,11 @@ namespace sim {
             return {x - o.x, y - o.y, z - o.z};
         }
 
-        [[nodiscard]] constexpr Vec3 operator*(const double s) const {
+        [[nodiscard]] constexpr Vec3 operator*(const Real s) const {
             return {x * s, y * s, z * s};
         }
 
-        [[nodiscard]] constexpr Vec3 operator/(const double s) const {
+        [[nodiscard]] constexpr Vec3 operator/(const Real s) const {
             return {x / s, y / s, z / s};
         }
 
@@ -43,25 +44,25 @@ namespace sim {
             return *this;
         }
 
-        constexpr Vec3& operator*=(const double s) {
+        constexpr Vec3& operator*=(const Real s) {
             x *= s;
             y *= s;
             z *= s;
             return *this;
         }
 
-        constexpr Vec3& operator/=(const double s) {
+        constexpr Vec3& operator/=(const Real s) {
             x /= s;
             y /= s;
             z /= s;
             return *this;
         }
 
-        [[nodiscard]] constexpr double dot(const Vec3& o) const {
+        [[nodiscard]] constexpr Real dot(const Vec3& o) const {
             return x * o.x + y * o.y + z * o.z;
         }
 
-        [[nodiscard]] double magnitude() const {
+        [[nodiscard]] Real magnitude() const {
             return std::sqrt(dot(*this));
         }
 
@@ -3,37 +3,97 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <ranges>
+#include <type_traits>
 
 namespace sim {
     namespace {
         [[nodiscard]] bool isDynamicBody(const Body& b) {
-            return std::isfinite(b.invMass) && b.invMass > 0.0;
+            return std::isfinite(b.invMass) && b.invMass > Real(0.0);
         }
 
-        [[nodiscard]] double derivedInvInertiaSphere(const Body& b) {
-            if (!std::isfinite(b.invMass) || b.invMass <= 0.0 || !std::isfinite(b.radius) || b.radius <= 0.0) {
+        [[nodiscard]] Real derivedInvInertiaSphere(const Body& b) {
+            if (!std::isfinite(b.invMass) || b.invMass <= Real(0.0) || !std::isfinite(b.radius) || b.radius <= Real(0.0)) {
                 return 0.0;
             }
-            return 2.5 * b.invMass / (b.radius * b.radius);
+            return Real(2.5) * b.invMass / (b.radius * b.radius);
         }
 
-        [[nodiscard]] double effectiveInvInertia(const Body& b) {
-            if (std::isfinite(b.invInertia) && b.invInertia > 0.0) {
+        // x * 0 is 0 for finite x and NaN for NaN or Inf, so one compare checks every field
+        // without branching.
+        [[nodiscard]] bool integratedStateFinite(const Body& b) {
+            const Real sum =
+                (b.position.x + b.position.y + b.position.z) * Real(0.0) +
+                (b.velocity.x + b.velocity.y + b.velocity.z) * Real(0.0) +
+                (b.angularVelocity.x + b.angularVelocity.y + b.angularVelocity.z) * Real(0.0) +
+                (b.torque.x + b.torque.y + b.torque.z) * Real(0.0) +
+                (b.orientation.w + b.orientation.x + b.orientation.y + b.orientation.z) * Real(0.0) +
+                b.sleepTimer * Real(0.0);
+            return sum == Real(0.0) && b.sleepTimer >= Real(0.0);
+        }
+
+        // Replaces non-finite or out-of-range fields with safe defaults. True if anything changed.
+        bool repairBody(Body& b) {
+            bool bodySanitized = false;
+            const auto mark = [&]() {
+                bodySanitized = true;
+            };
+
+            if (!std::isfinite(b.position.x) || !std::isfinite(b.position.y) || !std::isfinite(b.position.z)) {
+                b.position = Vec3(0.0, 0.0, 0.0); mark();
+            }
+            if (!std::isfinite(b.prevPosition.x) || !std::isfinite(b.prevPosition.y) || !std::isfinite(b.prevPosition.z)) {
+                b.prevPosition = b.position; mark();
+            }
+            if (!std::isfinite(b.velocity.x) || !std::isfinite(b.velocity.y) || !std::isfinite(b.velocity.z)) {
+                b.velocity = Vec3(0.0, 0.0, 0.0); mark();
+            }
+            if (!std::isfinite(b.angularVelocity.x) || !std::isfinite(b.angularVelocity.y) || !std::isfinite(b.angularVelocity.z)) {
+                b.angularVelocity = Vec3(0.0, 0.0, 0.0); mark();
+            }
+            if (!std::isfinite(b.torque.x) || !std::isfinite(b.torque.y) || !std::isfinite(b.torque.z)) {
+                b.torque = Vec3(0.0, 0.0, 0.0); mark();
+            }
+            if (!std::isfinite(b.invMass) || b.invMass < Real(0.0)) { b.invMass = Real(0.0); mark(); }
+            if (!std::isfinite(b.invInertia) || b.invInertia < Real(0.0)) { b.invInertia = Real(0.0); mark(); }
+            if (!std::isfinite(b.radius) || b.radius <= Real(0.0)) { b.radius = Real(1.0); mark(); }
+            if (!isValidMaterial(b.material)) {
+                b.material = kDefaultMaterial;
+                mark();
+            }
+            if (!std::isfinite(b.orientation.w) || !std::isfinite(b.orientation.x) || !std::isfinite(b.orientation.y) || !std::isfinite(b.orientation.z)) {
+                b.orientation = {}; mark();
+            } else {
+                normalizeQuat(b.orientation);
+            }
+            if (!std::isfinite(b.prevOrientation.w) || !std::isfinite(b.prevOrientation.x) ||
+                !std::isfinite(b.prevOrientation.y) || !std::isfinite(b.prevOrientation.z))
+            {
+                b.prevOrientation = b.orientation; mark();
+            } else {
+                normalizeQuat(b.prevOrientation);
+            }
+            if (b.invMass <= Real(0.0)) {
+                b.sleeping = false;
+                b.sleepTimer = 0.0;
+            } else if (!std::isfinite(b.sleepTimer) || b.sleepTimer < Real(0.0)) {
+                b.sleepTimer = 0.0;
+                b.sleeping = false;
+                mark();
+            }
+
+            return bodySanitized;
+        }
+
+        [[nodiscard]] Real effectiveInvInertia(const Body& b) {
+            if (std::isfinite(b.invInertia) && b.invInertia > Real(0.0)) {
                 return b.invInertia;
             }
             return derivedInvInertiaSphere(b);
         }
     } // namespace
 
-    std::size_t World::PairHash::operator()(const ContactKey& p) const
-    {
-        std::size_t h = 0xcbf29ce484222325ULL;
-        h ^= std::hash<std::uint64_t>{}(p.first) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
-        h ^= std::hash<std::uint64_t>{}(p.second) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
-        return h;
-    }
-
     World::World(const Params& params)
         : params_(params) {}
 
@@ -46,41 +106,167 @@ namespace sim {
         initBodies_();
     }
 
-    void World::step(const double dt)
+    void World::step(const Real dt)
+    {
+        StepStats stats{};
+        stepOnce_(dt, true, stats);
+        scratch_->release();
+    }
+
+    World::StepStats World::advance(const int steps, const Real dt)
     {
-        const int substeps = computeSubstepCount_(dt);
-        const double substepDt = dt / static_cast<double>(substeps);
-        for (int substep = 0; substep < substeps; ++substep) {
-            stepSingle_(substepDt);
+        StepStats stats{};
+        const std::uint64_t repairedBefore = repairedBodyCount_;
+        for (int k = 0; k < steps; ++k) {
+            if (k + 1 == steps) {
+                for (Body& body : bodies_) {
+                    body.prevPosition = body.position;
+                    body.prevOrientation = body.orientation;
+                }
+            }
+            stepOnce_(dt, k == 0, stats);
         }
+        scratch_->release();
+        stats.repairedBodies = repairedBodyCount_ - repairedBefore;
+        stats.sleepingBodies = sleepingBodyCount_;
+        stats.contactManifolds = contactCache_.size();
+        return stats;
     }
 
-    void World::stepSingle_(const double dt)
+    void World::stepOnce_(const Real dt, const bool first, StepStats& stats)
     {
-        beginContactFrame_();
-        prepareForces_();
-        computeForces_();
-        integrateVelocities_(dt * 0.5);
-        moveBodiesWithCCD_(dt);
-        sanitizeBodies_();
-        prepareForces_();
-        computeForces_();
-        integrateVelocities_(dt * 0.5);
-        sanitizeBodies_();
-        updateSleepState_(dt);
-        endContactFrame_();
+        // Only the first step of a batch can see edits made through bodies(); the others start
+        // from state the previous step left behind.
+        refreshActivity_(first);
+        reorderBodiesIfDue_();
+        if (first) {
+            refreshMaterialPairs_();
+        }
+        if (params_.deterministic) {
+            scratch_->movedBodies.assign(awakeBodies_.begin(), awakeBodies_.end());
+        }
+        if (params_.smallStepSolver && params_.enableCollisions) {
+            const int substeps = std::clamp(params_.smallSteps, 1, Params::kMaxSmallSteps);
+            forcesStale_ = true;
+            stats.awakeBodySteps += stepSmall_(dt) * static_cast<std::size_t>(substeps);
+            recordSubstep_(dt / static_cast<Real>(substeps), substeps, stats);
+        } else if (params_.adaptiveSubsteps) {
+            // Each substep is sized where it starts, then the rest of the step is split evenly at
+            // that size, so the last substep ends exactly at dt.
+            Real remaining = dt;
+            for (int substep = 0; substep < Params::kMaxAdaptiveSubsteps && remaining != Real(0.0); ++substep) {
+                const int substeps = std::min(
+                    computeSubstepCount_(remaining), Params::kMaxAdaptiveSubsteps - substep);
+                const Real substepDt = substeps == 1 ? remaining : remaining / static_cast<Real>(substeps);
+                stats.awakeBodySteps += stepSingle_(substepDt);
+                recordSubstep_(substepDt, 1, stats);
+                remaining -= substepDt;
+            }
+        } else {
+            const int substeps = computeSubstepCount_(dt);
+            const Real substepDt = dt / static_cast<Real>(substeps);
+            for (int substep = 0; substep < substeps; ++substep) {
+                stats.awakeBodySteps += stepSingle_(substepDt);
+            }
+            recordSubstep_(substepDt, substeps, stats);
+        }
+        if (params_.deterministic) {
+            updateStateHash_();
+        } else {
+            // Nothing keeps the per-body hashes in step; stateHash() rehashes from scratch.
+            stateHashValid_ = false;
+        }
+        ++stats.steps;
+        stats.simulatedTime += dt;
+    }
+
+    const FrameArena& World::scratchArena() const { return scratch_->arena; }
+    std::uint64_t World::repairedBodyCount() const { return repairedBodyCount_; }
+
+    void World::trimScratch()
+    {
+        scratch_->release();
+        scratch_->arena.release();
+    }
+
+    void World::StepScratch::release()
+    {
+        // Swapping with an empty vector drops the buffer; the arena takes it all back at once.
+        const auto drop = [](auto&... buffers) {
+            ((std::remove_reference_t<decltype(buffers)>(buffers.get_allocator()).swap(buffers)), ...);
+        };
+        drop(broadphase.intervals, broadphase.widths);
+        drop(partition.bodySlots, partition.bodyMasks, partition.pairBuckets, partition.cursor);
+        drop(sweptPairs, overlapPairs, collidingPairs, activePairs, reorderedPairs, originalPairs, bodyPairs);
+        drop(inertIndices, sleepCandidates, islandTimers, islandLabels, byIsland, islandMembers);
+        drop(sortKeys, newIndexOf, unassignedBodies, movedBodies, savedMotion);
+        arena.reset();
     }
 
-    void World::addBody(const Body& b)
+    std::size_t World::stepSingle_(const Real dt)
+    {
+        // Two graphs, because moving bodies can wake sleeping ones and so changes awakeBodies_,
+        // which the per-body phases after it are split over. Per-body phases only touch their own
+        // body, so neither chunking nor the pool size changes results.
+        constexpr std::size_t kBodyGrain = 1024;
+        jobs::JobSystem& jobs = jobSystem_();
+        jobs::TaskGraph& graph = scratch_->graph;
+        const Real halfDt = dt * Real(0.5);
+        resizeBodyState_();
+
+        graph.clear();
+        std::size_t awake = awakeBodies_.size();
+        const auto begin = graph.addTask([this]() { beginContactFrame_(); });
+        auto last = graph.add(awake, kBodyGrain, [this](std::size_t first, std::size_t end) {
+            clearForceRange_(first, end);
+        });
+        last = graph.addTask([this]() { computeForces_(); }, {last});
+        last = graph.add(awake, kBodyGrain, [this, halfDt](std::size_t first, std::size_t end) {
+            integrateVelocityRange_(halfDt, first, end);
+        }, {last});
+        graph.addTask([this, dt]() { moveBodiesWithCCD_(dt); }, {begin, last});
+        jobs.run(graph);
+
+        const bool fullSanitize = !params_.lazySanitization || bodiesExposed_;
+        bodiesExposed_ = false;
+        graph.clear();
+        awake = awakeBodies_.size();
+        last = graph.add(awake, kBodyGrain, [this, fullSanitize](std::size_t first, std::size_t end) {
+            sanitizeBodyRange_(fullSanitize, first, end);
+        });
+        last = graph.add(awake, kBodyGrain, [this](std::size_t first, std::size_t end) {
+            clearForceRange_(first, end);
+        }, {last});
+        last = graph.addTask([this]() { computeForces_(); }, {last});
+        last = graph.add(awake, kBodyGrain, [this, halfDt](std::size_t first, std::size_t end) {
+            integrateVelocityRange_(halfDt, first, end);
+        }, {last});
+        last = graph.add(awake, kBodyGrain, [this](std::size_t first, std::size_t end) {
+            sanitizeBodyRange_(!params_.lazySanitization, first, end);
+        }, {last});
+        // Cache aging only has to wait until the sleep links were read from the cache; it
+        // overlaps putting the settled islands to sleep.
+        last = graph.addTask([this, dt]() { linkSleepCandidates_(dt); }, {last});
+        graph.addTask([this]() { settleSleepIslands_(); }, {last});
+        graph.addTask([this]() { endContactFrame_(); }, {last});
+        jobs.run(graph);
+        repairedBodyCount_ += scratch_->repairs.exchange(0, std::memory_order_relaxed);
+        forcesStale_ = false;
+        return awake;
+    }
+
+    std::uint64_t World::addBody(const Body& b)
     {
         bodies_.push_back(b);
-        assignMaterial(bodies_.back(), bodies_.back().materialName);
         bodies_.back().prevPosition = bodies_.back().position;
         bodies_.back().prevOrientation = bodies_.back().orientation;
         bodies_.back().sleeping = false;
         bodies_.back().sleepTimer = 0.0;
-        assignBodyId_(bodies_.back());
+        assignBodyId_(bodies_.back(), bodies_.size() - 1);
         sanitizeBody_(bodies_.back());
+        stateHashValid_ = false;
+        forcesStale_ = true;
+        return bodies_.back().id;
     }
 
     void World::clear()
@@ -89,14 +275,43 @@ namespace sim {
         forces_.clear();
         contactTouchedBodies_.clear();
         contactCache_.clear();
-        nextBodyId_ = 1;
+        awakeBodies_.clear();
+        sleepIslandOfBody_.clear();
+        sleepIslandMembers_.clear();
+        sleepIslands_.clear();
+        sleepingIslandCount_ = 0;
+        sleepingBodyCount_ = 0;
+        inertSet_.clear();
+        inertSnapshots_.clear();
+        inertSetDirty_ = true;
+        bodySlots_.clear();
+        freeBodySlots_.clear();
+        previousBodyIndices_.clear();
+        stepsSinceReorder_ = 0;
+        stateHashValid_ = false;
+        forcesStale_ = true;
     }
 
-    std::vector<Body>& World::bodies() { return bodies_; }
+    std::vector<Body>& World::bodies()
+    {
+        bodiesExposed_ = true;
+        stateHashValid_ = false;
+        forcesStale_ = true;
+        return bodies_;
+    }
     const std::vector<Body>& World::bodies() const { return bodies_; }
     World::Params& World::params() { return params_; }
     const World::Params& World::params() const { return params_; }
 
+    jobs::JobSystem& World::jobSystem_()
+    {
+        const int requested = std::clamp(params_.workerThreads, 1, Params::kMaxWorkerThreads);
+        if (!jobs_ || jobs_->threadCount() != requested) {
+            jobs_ = std::make_unique<jobs::JobSystem>(requested);
+        }
+        return *jobs_;
+    }
+
     void World::prepareForces_()
     {
         if (bodies_.size() != forces_.size()) {
@@ -105,91 +320,244 @@ namespace sim {
         if (bodies_.size() != contactTouchedBodies_.size()) {
             contactTouchedBodies_.resize(bodies_.size());
         }
-        std::ranges::fill(forces_, Vec3{});
+        clearForceRange_(0, awakeBodies_.size());
     }
 
-    int World::computeSubstepCount_(const double dt) const
+    void World::clearForceRange_(const std::size_t begin, const std::size_t end)
     {
-        const double absDt = std::abs(dt);
-        if (!(absDt > 0.0)) {
+        // Entries of inert bodies are never read; they are cleared when a body wakes.
+        for (std::size_t k = begin; k < end; ++k) {
+            forces_[awakeBodies_[k]] = Vec3{};
+        }
+    }
+
+    int World::computeSubstepCount_(const Real dt)
+    {
+        const Real absDt = std::abs(dt);
+        if (!(absDt > Real(0.0))) {
             return 1;
         }
 
-        const double maxSubstepDt =
-            (std::isfinite(params_.maxSubstepDt) && params_.maxSubstepDt > 0.0)
+        const Real maxSubstepDt =
+            (std::isfinite(params_.maxSubstepDt) && params_.maxSubstepDt > Real(0.0))
                 ? params_.maxSubstepDt
                 : Params::kDefaultMaxSubstepDt;
-        const int maxSubsteps = std::clamp(params_.maxSubsteps, 1, Params::kDefaultMaxSubsteps);
-        const int requested = static_cast<int>(std::ceil(absDt / maxSubstepDt));
-        return std::clamp(requested, 1, maxSubsteps);
+        if (!params_.adaptiveSubsteps) {
+            const int maxSubsteps = std::clamp(params_.maxSubsteps, 1, Params::kDefaultMaxSubsteps);
+            const int requested = static_cast<int>(std::ceil(absDt / maxSubstepDt));
+            return std::clamp(requested, 1, maxSubsteps);
+        }
+
+        // The forces the last substep ended with belong to the current positions, so they are
+        // only recomputed after edits, removals or wakes, or a step that did not leave them.
+        resizeBodyState_();
+        if (forcesStale_) {
+            prepareForces_();
+            computeForces_();
+            forcesStale_ = false;
+        }
+        const Real tolerance = (std::isfinite(params_.adaptiveTolerance) && params_.adaptiveTolerance > Real(0.0))
+            ? params_.adaptiveTolerance
+            : Params::kDefaultAdaptiveTolerance;
+        bool touching = false;
+        Real timeScale = adaptiveTimeScale_(touching);
+        if (params_.symmetricSubsteps && std::isfinite(timeScale)) {
+            timeScale = Real(0.5) * (timeScale + predictedTimeScale_(std::min(absDt, tolerance * timeScale)));
+        }
+
+        Real substepDt = std::isfinite(timeScale) ? tolerance * timeScale : absDt;
+        if (touching) {
+            substepDt = std::min(substepDt, maxSubstepDt);
+        }
+        const Real requested = std::ceil(absDt / std::max<Real>(substepDt, std::numeric_limits<Real>::min()));
+        return static_cast<int>(std::clamp<Real>(requested, 1.0, Params::kMaxAdaptiveSubsteps));
     }
 
+    Real World::adaptiveTimeScale_(bool& touching) const
+    {
+        Real timeScale = std::numeric_limits<Real>::infinity();
+        for (const std::size_t i : awakeBodies_) {
+            const Body& body = bodies_[i];
+            if (!isDynamicBody(body)) {
+                continue;
+            }
+            touching = touching || (i < contactTouchedBodies_.size() && contactTouchedBodies_[i]);
+            const Real speed = body.velocity.magnitude();
+            const Real acceleration = forces_[i].magnitude() * body.invMass;
+            if (speed > Real(0.0)) {
+                timeScale = std::min(timeScale, body.radius / speed);
+            }
+            if (acceleration > Real(0.0)) {
+                timeScale = std::min(timeScale, std::max(speed / acceleration, std::sqrt(body.radius / acceleration)));
+            }
+        }
+        return timeScale;
+    }
+
+    Real World::predictedTimeScale_(const Real dt)
+    {
+        // Drifts every awake body dt ahead at constant acceleration, measures there, and puts
+        // everything back. Forces are left at the predicted positions and marked stale; the
+        // substep recomputes them before it reads them.
+        auto& saved = scratch_->savedMotion;
+        saved.clear();
+        for (const std::size_t i : awakeBodies_) {
+            Body& body = bodies_[i];
+            saved.emplace_back(body.position, body.velocity);
+            if (isDynamicBody(body)) {
+                const Vec3 acceleration = forces_[i] * body.invMass;
+                body.position += body.velocity * dt + acceleration * (Real(0.5) * dt * dt);
+                body.velocity += acceleration * dt;
+            }
+        }
+        prepareForces_();
+        computeForces_();
+        bool touching = false;
+        const Real timeScale = adaptiveTimeScale_(touching);
+        for (std::size_t k = 0; k < awakeBodies_.size(); ++k) {
+            Body& body = bodies_[awakeBodies_[k]];
+            body.position = saved[k].first;
+            body.velocity = saved[k].second;
+        }
+        forcesStale_ = true;
+        return std::isfinite(timeScale) ? timeScale : dt;
+    }
+
+    void World::recordSubstep_(const Real substepDt, const int count, StepStats& stats)
+    {
+        const Real length = std::abs(substepDt);
+        stats.minSubstepDt = stats.substeps == 0 ? length : std::min(stats.minSubstepDt, length);
+        stats.maxSubstepDt = std::max(stats.maxSubstepDt, length);
+        stats.substeps += count;
+        lastSubstepDt_ = length;
+    }
+
+    Real World::lastSubstepDt() const { return lastSubstepDt_; }
+
     void World::computeForces_()
     {
         if (!params_.enableGravity || bodies_.size() < 2) {
             return;
         }
 
-        thread_local std::vector<std::size_t> dynamicBodies;
-        dynamicBodies.clear();
-        dynamicBodies.reserve(bodies_.size());
-
-        for (std::size_t i = 0; i < bodies_.size(); ++i) {
+        GravityArrays& targets = gravityTargets_;
+        targets.clear();
+        for (const std::size_t i : awakeBodies_) {
             if (isDynamicBody(bodies_[i])) {
-                dynamicBodies.push_back(i);
+                targets.push(i, bodies_[i]);
             }
         }
-        if (dynamicBodies.size() < 2) {
+        if (targets.body.empty()) {
             return;
         }
 
-        for (std::size_t a = 0; a + 1 < dynamicBodies.size(); ++a) {
-            const std::size_t i = dynamicBodies[a];
-            for (std::size_t b = a + 1; b < dynamicBodies.size(); ++b) {
-                applyGravityPair_(i, dynamicBodies[b]);
+        accumulateGravity_(targets, true);
+
+        // Sleeping bodies still attract awake ones, but are not gravity targets themselves.
+        if (sleepingBodyCount_ > 0) {
+            GravityArrays& sources = gravitySources_;
+            sources.clear();
+            for (const SleepIsland& island : sleepIslands_) {
+                for (std::size_t m = island.begin; m < island.end; ++m) {
+                    sources.push(sleepIslandMembers_[m], bodies_[sleepIslandMembers_[m]]);
+                }
             }
+            accumulateGravity_(sources, false);
+        }
+
+        for (std::size_t a = 0; a < targets.body.size(); ++a) {
+            forces_[targets.body[a]] += Vec3(targets.fx[a], targets.fy[a], targets.fz[a]);
         }
     }
 
-    void World::applyGravityPair_(const std::size_t i, const std::size_t j)
+    void World::accumulateGravity_(const GravityArrays& sources, const bool mutual)
     {
-        const Body& A = bodies_[i];
-        const Body& B = bodies_[j];
-
-        if (A.invMass == 0.0 || B.invMass == 0.0) {
-            return;
+        // mutual: sources are the targets themselves and every pair is visited once, with equal
+        // and opposite forces. Otherwise sources pull on targets without being pulled back.
+        GravityArrays& t = gravityTargets_;
+        const Real G = params_.G;
+        const std::size_t targetCount = t.body.size();
+        const std::size_t sourceCount = sources.body.size();
+        for (std::size_t a = 0; a < targetCount; ++a) {
+            const Real xA = t.x[a];
+            const Real yA = t.y[a];
+            const Real zA = t.z[a];
+            const Real wA = t.invMass[a];
+            const Real rA = t.radius[a];
+            Real fx = t.fx[a];
+            Real fy = t.fy[a];
+            Real fz = t.fz[a];
+            for (std::size_t b = mutual ? a + 1 : 0; b < sourceCount; ++b) {
+                const Real dx = sources.x[b] - xA;
+                const Real dy = sources.y[b] - yA;
+                const Real dz = sources.z[b] - zA;
+                const Real r2 = dx * dx + dy * dy + dz * dz;
+                const Real eps = (rA + sources.radius[b]) * Real(1e-6);
+                const Real r2Soft = r2 + eps * eps;
+                const Real invMassProduct = wA * sources.invMass[b];
+                const Real invR = Real(1.0) / std::sqrt(r2Soft);
+                const Real invR3 = invR * invR * invR;
+                const bool valid = std::isfinite(invMassProduct) && invMassProduct > Real(0.0);
+                const Real scale = valid ? (G / invMassProduct) * invR3 : Real(0.0);
+                fx += dx * scale;
+                fy += dy * scale;
+                fz += dz * scale;
+                if (mutual) {
+                    t.fx[b] -= dx * scale;
+                    t.fy[b] -= dy * scale;
+                    t.fz[b] -= dz * scale;
+                }
+            }
+            t.fx[a] = fx;
+            t.fy[a] = fy;
+            t.fz[a] = fz;
         }
+    }
 
-        const Vec3 d = B.position - A.position;
-        const double r2 = d.dot(d);
-        const double eps = (A.radius + B.radius) * 1e-6;
-        const double r2Soft = r2 + eps * eps;
+    void World::GravityArrays::clear()
+    {
+        body.clear();
+        x.clear();
+        y.clear();
+        z.clear();
+        invMass.clear();
+        radius.clear();
+        fx.clear();
+        fy.clear();
+        fz.clear();
+    }
 
-        const double invMassProduct = A.invMass * B.invMass;
-        if (!std::isfinite(invMassProduct) || invMassProduct <= 0.0) {
-            return;
-        }
+    void World::GravityArrays::push(const std::size_t index, const Body& b)
+    {
+        body.push_back(index);
+        x.push_back(b.position.x);
+        y.push_back(b.position.y);
+        z.push_back(b.position.z);
+        invMass.push_back(b.invMass);
+        radius.push_back(b.radius);
+        fx.push_back(0.0);
+        fy.push_back(0.0);
+        fz.push_back(0.0);
+    }
 
-        const double invR = 1.0 / std::sqrt(r2Soft);
-        const double invR3 = invR * invR * invR;
-        const double forceScale = (params_.G / invMassProduct) * invR3;
-        const Vec3 f12 = d * forceScale;
-        forces_[i] += f12;
-        forces_[j] -= f12;
+    void World::integrateVelocities_(const Real dt)
+    {
+        integrateVelocityRange_(dt, 0, awakeBodies_.size());
     }
 
-    void World::integrateVelocities_(const double dt)
+    void World::integrateVelocityRange_(const Real dt, const std::size_t begin, const std::size_t end)
     {
-        for (std::size_t i = 0; i < bodies_.size(); ++i) {
+        for (std::size_t k = begin; k < end; ++k) {
+            const std::size_t i = awakeBodies_[k];
             Body& b = bodies_[i];
-            if (b.invMass == 0.0 || b.sleeping) {
+            if (b.invMass == Real(0.0) || b.sleeping) {
                 continue;
             }
             const Vec3 a = forces_[i] * b.invMass;
             b.velocity += a * dt;
 
-            const double invI = effectiveInvInertia(b);
-            if (invI > 0.0) {
+            const Real invI = effectiveInvInertia(b);
+            if (invI > Real(0.0)) {
                 const Vec3 alpha = b.torque * invI;
                 b.angularVelocity += alpha * dt;
             }
@@ -197,9 +565,10 @@ namespace sim {
         }
     }
 
-    void World::advancePositions_(const double dt)
+    void World::advancePositions_(const Real dt)
     {
-        for (auto& b : bodies_) {
+        for (const std::size_t i : awakeBodies_) {
+            Body& b = bodies_[i];
             if (b.sleeping) {
                 continue;
             }
@@ -208,143 +577,49 @@ namespace sim {
         }
     }
 
-    void World::sanitizeBody_(Body& b)
+    bool World::sanitizeBody_(Body& b)
     {
-        const Material& fallbackMaterial = defaultMaterial();
-
-        bool bodySanitized = false;
-        const auto mark = [&]() {
-            bodySanitized = true;
-        };
-
-        if (!std::isfinite(b.position.x) || !std::isfinite(b.position.y) || !std::isfinite(b.position.z)) {
-            b.position = Vec3(0.0, 0.0, 0.0); mark();
-        }
-        if (!std::isfinite(b.prevPosition.x) || !std::isfinite(b.prevPosition.y) || !std::isfinite(b.prevPosition.z)) {
-            b.prevPosition = b.position; mark();
-        }
-        if (!std::isfinite(b.velocity.x) || !std::isfinite(b.velocity.y) || !std::isfinite(b.velocity.z)) {
-            b.velocity = Vec3(0.0, 0.0, 0.0); mark();
-        }
-        if (!std::isfinite(b.angularVelocity.x) || !std::isfinite(b.angularVelocity.y) || !std::isfinite(b.angularVelocity.z)) {
-            b.angularVelocity = Vec3(0.0, 0.0, 0.0); mark();
-        }
-        if (!std::isfinite(b.torque.x) || !std::isfinite(b.torque.y) || !std::isfinite(b.torque.z)) {
-            b.torque = Vec3(0.0, 0.0, 0.0); mark();
-        }
-        if (!std::isfinite(b.invMass) || b.invMass < 0.0) { b.invMass = 0.0; mark(); }
-        if (!std::isfinite(b.invInertia) || b.invInertia < 0.0) { b.invInertia = 0.0; mark(); }
-        if (!std::isfinite(b.radius) || b.radius <= 0.0) { b.radius = 1.0; mark(); }
-        if (b.materialName.empty()) {
-            assignMaterial(b, kDefaultMaterialName);
-            mark();
-        }
-        if (!std::isfinite(b.restitution)) { b.restitution = fallbackMaterial.restitution; mark(); }
-        const double oldRest = b.restitution;
-        b.restitution = std::clamp(b.restitution, 0.0, 1.0);
-        if (b.restitution != oldRest) mark();
-        if (!std::isfinite(b.staticFriction) || b.staticFriction < 0.0) { b.staticFriction = fallbackMaterial.staticFriction; mark(); }
-        if (!std::isfinite(b.dynamicFriction) || b.dynamicFriction < 0.0) { b.dynamicFriction = fallbackMaterial.dynamicFriction; mark(); }
-        if (b.dynamicFriction > b.staticFriction) { b.dynamicFriction = b.staticFriction; mark(); }
-        if (!std::isfinite(b.orientation.w) || !std::isfinite(b.orientation.x) || !std::isfinite(b.orientation.y) || !std::isfinite(b.orientation.z)) {
-            b.orientation = {}; mark();
-        } else {
-            normalizeQuat(b.orientation);
-        }
-        if (!std::isfinite(b.prevOrientation.w) || !std::isfinite(b.prevOrientation.x) ||
-            !std::isfinite(b.prevOrientation.y) || !std::isfinite(b.prevOrientation.z))
-        {
-            b.prevOrientation = b.orientation; mark();
-        } else {
-            normalizeQuat(b.prevOrientation);
-        }
-        if (b.invMass <= 0.0) {
-            b.sleeping = false;
-            b.sleepTimer = 0.0;
-        } else if (!std::isfinite(b.sleepTimer) || b.sleepTimer < 0.0) {
-            b.sleepTimer = 0.0;
-            b.sleeping = false;
-            mark();
+        const bool repaired = repairBody(b);
+        if (repaired) {
+            ++repairedBodyCount_;
         }
-
-        (void)bodySanitized;
+        return repaired;
     }
 
     void World::sanitizeBodies_()
     {
-        for (auto& b : bodies_) {
-            sanitizeBody_(b);
-        }
+        sanitizeBodyRange_(!params_.lazySanitization || bodiesExposed_, 0, awakeBodies_.size());
+        bodiesExposed_ = false;
+        repairedBodyCount_ += scratch_->repairs.exchange(0, std::memory_order_relaxed);
     }
 
-    void World::assignBodyId_(Body& b)
+    void World::sanitizeBodyRange_(const bool full, const std::size_t begin, const std::size_t end)
     {
-        b.id = nextBodyId_++;
+        // Between full passes only integration writes bodies, and it keeps orientations
+        // normalized, so a body whose integrated fields are all finite needs no repair.
+        std::uint64_t repaired = 0;
+        for (std::size_t k = begin; k < end; ++k) {
+            Body& b = bodies_[awakeBodies_[k]];
+            if ((full || !integratedStateFinite(b)) && repairBody(b)) {
+                ++repaired;
+            }
+        }
+        if (repaired > 0) {
+            scratch_->repairs.fetch_add(repaired, std::memory_order_relaxed);
+        }
     }
 
     void World::initBodies_()
     {
-        for (auto& body : bodies_) {
-            assignMaterial(body, body.materialName);
+        for (std::size_t i = 0; i < bodies_.size(); ++i) {
+            Body& body = bodies_[i];
             body.prevPosition = body.position;
             body.prevOrientation = body.orientation;
             body.sleeping = false;
             body.sleepTimer = 0.0;
-            assignBodyId_(body);
+            assignBodyId_(body, i);
             sanitizeBody_(body);
         }
     }
 
-    void World::wakeBody_(Body& b)
-    {
-        if (!isDynamicBody(b)) {
-            return;
-        }
-        b.sleeping = false;
-        b.sleepTimer = 0.0;
-    }
-
-    void World::updateSleepState_(const double dt)
-    {
-        if (!params_.enableSleeping) {
-            for (auto& body : bodies_) {
-                wakeBody_(body);
-            }
-            return;
-        }
-
-        const double linearThreshold = std::max(0.0, params_.sleepLinearThreshold);
-        const double angularThreshold = std::max(0.0, params_.sleepAngularThreshold);
-        const double linearThreshold2 = linearThreshold * linearThreshold;
-        const double angularThreshold2 = angularThreshold * angularThreshold;
-        const double requiredSleepTime = std::max(0.0, params_.sleepTime);
-
-        for (std::size_t i = 0; i < bodies_.size(); ++i) {
-            Body& body = bodies_[i];
-            if (!isDynamicBody(body)) {
-                continue;
-            }
-
-            const bool touching = i < contactTouchedBodies_.size() && contactTouchedBodies_[i];
-            const bool eligibleForSleep = !params_.enableGravity || touching;
-            const double linearSpeed2 = body.velocity.dot(body.velocity);
-            const double angularSpeed2 = body.angularVelocity.dot(body.angularVelocity);
-            const bool belowThresholds =
-                linearSpeed2 <= linearThreshold2 &&
-                angularSpeed2 <= angularThreshold2;
-
-            if (eligibleForSleep && belowThresholds) {
-                body.sleepTimer += dt;
-                if (body.sleepTimer >= requiredSleepTime) {
-                    body.sleeping = true;
-                    body.velocity = Vec3{};
-                    body.angularVelocity = Vec3{};
-                }
-            } else {
-                body.sleepTimer = 0.0;
-                body.sleeping = false;
-            }
-        }
-    }
-
 } // namespace sim
@@ -1,50 +1,92 @@
 #ifndef PHYSICS3D_WORLD_H
 #define PHYSICS3D_WORLD_H
 
+#include <atomic>
 #include <cstdint>
 #include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <span>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 #include "Body.h"
+#include "Broadphase.h"
 #include "Collision.h"
+#include "ContactIslands.h"
+#include "ContactSolver.h"
+#include "FlatPairMap.h"
+#include "FrameArena.h"
+#include "JobSystem.h"
+#include "Material.h"
 
 namespace sim {
 
     class World {
     public:
         struct Params {
-            static constexpr double kDefaultG = 6.6743e-11;
-            static constexpr double kDefaultRestitution = 0.5;
-            static constexpr double kDefaultPenetrationSlop = 1e-4;
-            static constexpr double kDefaultPositionCorrectionPercent = 0.8;
+            static constexpr Real kDefaultG = 6.6743e-11;
+            static constexpr Real kDefaultRestitution = 0.5;
+            static constexpr Real kDefaultPenetrationSlop = 1e-4;
+            static constexpr Real kDefaultPositionCorrectionPercent = 0.8;
             static constexpr int kDefaultVelocityIterations = 2;
             static constexpr int kDefaultPositionIterations = 2;
-            static constexpr double kDefaultMaxSubstepDt = 1.0 / 60.0;
+            static constexpr Real kDefaultMaxSubstepDt = 1.0 / 60.0;
             static constexpr int kDefaultMaxSubsteps = 4;
             static constexpr int kDefaultMaxCcdIterationsPerStep = 64;
             static constexpr int kDefaultMaxRepeatedZeroToiPairs = 4;
-            static constexpr double kDefaultSleepLinearThreshold = 0.02;
-            static constexpr double kDefaultSleepAngularThreshold = 0.02;
-            static constexpr double kDefaultSleepTime = 0.5;
-
-            double G = kDefaultG;
-            double restitution = kDefaultRestitution; // Global upper bound for contact restitution [0..1]
-            double penetrationSlop = kDefaultPenetrationSlop; // Advanced collision tuning
-            double positionCorrectionPercent = kDefaultPositionCorrectionPercent; // Advanced collision tuning
+            static constexpr Real kDefaultSleepLinearThreshold = 0.02;
+            static constexpr Real kDefaultSleepAngularThreshold = 0.02;
+            static constexpr Real kDefaultSleepTime = 0.5;
+            static constexpr int kDefaultWorkerThreads = 1;
+            static constexpr int kMaxWorkerThreads = 64;
+            static constexpr int kDefaultContactSolverLanes = 1;
+            static constexpr int kDefaultSmallSteps = 4;
+            static constexpr int kMaxSmallSteps = 64;
+            static constexpr Real kDefaultAdaptiveTolerance = 0.05;
+            static constexpr int kMaxAdaptiveSubsteps = 256;
+
+            Real G = kDefaultG;
+            Real restitution = kDefaultRestitution; // Global upper bound for contact restitution [0..1]
+            Real penetrationSlop = kDefaultPenetrationSlop; // Advanced collision tuning
+            Real positionCorrectionPercent = kDefaultPositionCorrectionPercent; // Advanced collision tuning
             int velocityIterations = kDefaultVelocityIterations;
             int positionIterations = kDefaultPositionIterations;
-            double maxSubstepDt = kDefaultMaxSubstepDt;
+            Real maxSubstepDt = kDefaultMaxSubstepDt;
             int maxSubsteps = kDefaultMaxSubsteps;
             int maxCcdIterationsPerStep = kDefaultMaxCcdIterationsPerStep;
             int maxRepeatedZeroToiPairs = kDefaultMaxRepeatedZeroToiPairs;
-            double sleepLinearThreshold = kDefaultSleepLinearThreshold;
-            double sleepAngularThreshold = kDefaultSleepAngularThreshold;
-            double sleepTime = kDefaultSleepTime;
+            Real sleepLinearThreshold = kDefaultSleepLinearThreshold;
+            Real sleepAngularThreshold = kDefaultSleepAngularThreshold;
+            Real sleepTime = kDefaultSleepTime;
+            int workerThreads = kDefaultWorkerThreads; // Threads for step phases and contact solving, including the caller; 1 runs inline
+            int contactSolverLanes = kDefaultContactSolverLanes; // 1 = sequential order, 4 or 8 = colored lane batches
             bool enableGravity = true;
             bool enableCollisions = true;
             bool enableSleeping = true;
+            bool accumulateContactImpulses = false; // Clamped running totals, warm-started exactly from the cache
+            bool splitImpulse = false; // Penetration solved via pseudo displacement in the velocity loop, no position loop
+            bool smallStepSolver = false; // TGS: one broadphase and contact prep per step, then relaxed substeps
+            int smallSteps = kDefaultSmallSteps; // Substeps per step in small-step mode (replaces maxSubsteps)
+            int reorderInterval = 0; // Steps between Morton-order body reorders; 0 keeps insertion order
+            bool lazySanitization = false; // Full body checks only after bodies() was handed out; see repairedBodyCount
+            bool deterministic = false; // Same result for any workerThreads; stateHash() kept up to date every step
+            bool adaptiveSubsteps = false; // Substep size from speed, acceleration and contacts; see lastSubstepDt
+            bool symmetricSubsteps = false; // Adaptive size averaged with the one at the predicted end of the step
+            Real adaptiveTolerance = kDefaultAdaptiveTolerance; // Fraction of the shortest time scale one substep may span
+        };
+
+        // Totals over one advance() call.
+        struct StepStats {
+            int steps = 0;
+            int substeps = 0;
+            Real simulatedTime = 0.0;
+            std::uint64_t awakeBodySteps = 0; // Bodies each substep stepped, including ones it woke: the work actually done
+            Real minSubstepDt = 0.0;
+            Real maxSubstepDt = 0.0;
+            std::uint64_t repairedBodies = 0;
+            std::size_t sleepingBodies = 0; // After the last step
+            std::size_t contactManifolds = 0; // After the last step
         };
 
         World() = default;
@@ -52,11 +94,63 @@ namespace sim {
         explicit World(std::vector<Body> bodies);
         World(std::vector<Body> bodies, const Params& params);
 
-        void step(double dt);
+        void step(Real dt);
+        // Same result as steps calls to step(dt), for headless runs and catching up. Body ids are
+        // synced and the scratch arena rewound once per call instead of once per step, and every
+        // body's prevPosition and prevOrientation are set to the state before the last step, so
+        // the result can be interpolated like a single step.
+        StepStats advance(int steps, Real dt);
 
-        void addBody(const Body& b);
+        // Body ids are stable handles: each packs a slot and that slot's generation, so an id
+        // never names another body after its own was removed. Lookup and removal are O(1);
+        // removal moves the last body into the hole, so indices are not stable across it.
+        static constexpr std::size_t kNoBody = static_cast<std::size_t>(-1);
+
+        std::uint64_t addBody(const Body& b);
+        bool removeBody(std::uint64_t id);
+        [[nodiscard]] std::size_t indexOf(std::uint64_t id) const; // kNoBody for stale or unknown ids
         void clear();
 
+        // With reorderInterval set, bodies are periodically sorted along a Morton curve so that
+        // neighbours in space are neighbours in memory. Ids are unchanged; state kept per index
+        // outside the world can be remapped with the index each body had before the last reorder.
+        [[nodiscard]] std::span<const std::size_t> previousBodyIndices() const;
+        [[nodiscard]] std::uint64_t reorderCount() const;
+
+        // All step-local working memory comes from this world's frame arena, which step() and
+        // advance() rewind when they return. trimScratch() hands the arena's memory back to the heap.
+        [[nodiscard]] const FrameArena& scratchArena() const;
+        void trimScratch();
+
+        // Bodies found with invalid state and repaired, since construction. With lazySanitization
+        // the full checks run only on the first pass after the mutable bodies() was called; other
+        // passes scan the fields integration writes for NaN and Inf and repair just those bodies.
+        // Edits must therefore go through a bodies() call made after the previous step.
+        [[nodiscard]] std::uint64_t repairedBodyCount() const;
+
+        // Hash of every body's id and simulated state (position, orientation, velocities, sleep
+        // state). It is a sum over bodies, so it does not depend on body order. In deterministic
+        // mode each step refreshes it from the bodies that moved; otherwise, and after any edit
+        // through the mutable bodies(), it is computed from scratch on the call.
+        [[nodiscard]] std::uint64_t stateHash() const;
+
+        // Substep length the last step used. Fixed substeps split a step evenly into pieces no
+        // longer than maxSubstepDt, at most maxSubsteps of them. Adaptive substeps instead take
+        // adaptiveTolerance times the shortest time scale among awake bodies: radius over speed,
+        // and speed over acceleration (or sqrt(radius / acceleration) when that is longer), the
+        // latter being an orbit's period over 2 pi. Contacts only cap the substep: any awake body
+        // touching another holds it at maxSubstepDt, the rate the contact solver is tuned for,
+        // however many contacts there are. A calm step may then run as one substep whatever its
+        // length, and a close encounter as up to kMaxAdaptiveSubsteps. Sizing reads the forces
+        // the previous substep ended with, so it costs no gravity evaluation of its own unless
+        // bodies were edited, added, removed or woken since.
+        // The symmetric variant averages the time scale at the start of the substep with the one
+        // at a predicted end, which keeps the step choice close to time-reversible and so stops
+        // the systematic energy drift plain adaptive stepping gives orbits. The prediction is a
+        // full gravity evaluation, O(n^2) without a tree, on top of the two every substep does:
+        // half as much gravity work again as plain adaptive substeps.
+        [[nodiscard]] Real lastSubstepDt() const;
+
         std::vector<Body>& bodies();
         [[nodiscard]] const std::vector<Body>& bodies() const;
 
@@ -66,15 +160,15 @@ namespace sim {
     private:
         using ContactKey = std::pair<std::uint64_t, std::uint64_t>;
 
-        struct PairHash {
-            std::size_t operator()(const ContactKey& p) const;
-        };
-
         struct ContactManifold {
-            double normalImpulse = 0.0;
-            double tangentImpulse = 0.0;
+            Real normalImpulse = 0.0;
+            Real tangentImpulse = 0.0;
+            Vec3 frictionImpulse{};
             Vec3 normal{};
+            std::size_t bodyA = 0; // Body indices, valid only while touched: rewritten every frame that touches the manifold
+            std::size_t bodyB = 0;
             bool touched = false;
+            bool appliedThisFrame = false; // Cached totals are already part of the body velocities
             std::size_t staleFrames = 0;
         };
 
@@ -83,38 +177,213 @@ namespace sim {
             std::size_t j = 0;
             ContactKey key{};
             collision::SolveParams params{};
-            double accumulatedImpulse = 0.0;
+            Real accumulatedImpulse = 0.0;
+            Vec3 accumulatedFriction{};
+        };
+
+        struct ColorBatch {
+            std::size_t begin = 0;
+            std::size_t end = 0;
+            bool serial = false;
+        };
+
+        // Pair ranges for one collidePairs_ call: islands solved one task each, then the color
+        // batches of large islands, each a parallel pass with a barrier after it.
+        struct SolveSchedule {
+            std::vector<std::pair<std::size_t, std::size_t>> islandRanges{};
+            std::vector<ColorBatch> colorBatches{};
+        };
+
+        static constexpr std::uint32_t kNoSleepIsland = 0xffffffffu;
+
+        // A group of bodies that fell asleep together; members live in sleepIslandMembers_.
+        // Waking any member wakes the whole range, after which it is left empty.
+        struct SleepIsland {
+            std::size_t begin = 0;
+            std::size_t end = 0;
+        };
+
+        // Structure-of-arrays copy of the fields the gravity kernel reads, packed once per force
+        // evaluation. The O(n^2) pair loop then streams a few dense arrays instead of whole Bodies.
+        struct GravityArrays {
+            std::vector<std::size_t> body{};
+            std::vector<Real> x{};
+            std::vector<Real> y{};
+            std::vector<Real> z{};
+            std::vector<Real> invMass{};
+            std::vector<Real> radius{};
+            std::vector<Real> fx{};
+            std::vector<Real> fy{};
+            std::vector<Real> fz{};
+
+            void clear();
+            void push(std::size_t index, const Body& b);
+        };
+
+        // Combined contact parameters of two materials, precomputed for every registered pair.
+        struct MaterialPair {
+            Real restitution = 0.0;
+            Real staticFriction = 0.0;
+            Real dynamicFriction = 0.0;
+        };
+
+        static constexpr std::uint32_t kFreeBodySlot = 0xffffffffu;
+
+        // Slot-map entry behind a body id. The generation is bumped every time the slot is
+        // reused, so ids of removed bodies stay dead.
+        struct BodySlot {
+            std::uint32_t generation = 0;
+            std::uint32_t index = kFreeBodySlot; // Into bodies_ while live
+        };
+
+        // Scratch buffers for one step, all on one arena. Held by pointer so that the buffers
+        // keep pointing at their arena when the World is moved.
+        struct StepScratch {
+            FrameArena arena{};
+            broadphase::Scratch broadphase{&arena};
+            islands::PartitionScratch partition{&arena};
+            broadphase::PairList sweptPairs{&arena};
+            broadphase::PairList overlapPairs{&arena};
+            broadphase::PairList collidingPairs{&arena};
+            std::pmr::vector<ActiveCollisionPair> activePairs{&arena};
+            std::pmr::vector<ActiveCollisionPair> reorderedPairs{&arena};
+            std::pmr::vector<ActiveCollisionPair> originalPairs{&arena};
+            std::pmr::vector<islands::PairIndex> bodyPairs{&arena};
+            std::pmr::vector<std::size_t> inertIndices{&arena};
+            std::pmr::vector<std::size_t> sleepCandidates{&arena};
+            std::pmr::vector<Real> islandTimers{&arena};
+            std::pmr::vector<std::size_t> islandLabels{&arena};
+            std::pmr::vector<std::pair<std::size_t, std::size_t>> byIsland{&arena};
+            std::pmr::vector<std::size_t> islandMembers{&arena};
+            std::pmr::vector<std::pair<std::uint64_t, std::size_t>> sortKeys{&arena};
+            std::pmr::vector<std::size_t> newIndexOf{&arena};
+            std::pmr::vector<std::size_t> unassignedBodies{&arena};
+            std::pmr::vector<std::size_t> movedBodies{&arena}; // Whose state hash the step must refresh
+            std::pmr::vector<std::pair<Vec3, Vec3>> savedMotion{&arena}; // Position and velocity around a prediction
+            jobs::TaskGraph graph{};
+            std::atomic<std::uint64_t> repairs{0}; // Summed by parallel sanitization, then moved to repairedBodyCount_
+
+            // Drops every buffer, then rewinds the arena.
+            void release();
+        };
+
+        // Bounds an inert body had when the inert broadphase set was built.
+        struct InertSnapshot {
+            Vec3 position{};
+            Real radius = 0.0;
+            bool inert = false;
         };
 
         Params params_;
         std::vector<Body> bodies_{};
-        std::unordered_map<ContactKey, ContactManifold, PairHash> contactCache_{};
-        std::uint64_t nextBodyId_ = 1;
+        FlatPairMap<ContactManifold> contactCache_{};
+        std::vector<BodySlot> bodySlots_{};
+        std::vector<std::uint32_t> freeBodySlots_{};
+        std::vector<std::size_t> previousBodyIndices_{};
+        std::size_t stepsSinceReorder_ = 0;
+        std::uint64_t reorderCount_ = 0;
+        std::uint64_t repairedBodyCount_ = 0;
+        Real lastSubstepDt_ = 0.0;
+        bool bodiesExposed_ = true; // The mutable bodies() was called since the last full sanitization
+        bool forcesStale_ = true; // forces_ may not match the current positions of the awake bodies
+        std::vector<std::uint64_t> bodyHashes_{}; // Per index, summed into stateHash_
+        std::uint64_t stateHash_ = 0;
+        bool stateHashValid_ = false; // bodyHashes_ match bodies_ as of the end of the last step
 
         std::vector<Vec3> forces_{};
         std::vector<bool> contactTouchedBodies_{};
-        void stepSingle_(double dt);
+        std::unique_ptr<jobs::JobSystem> jobs_{};
+        islands::DisjointSet islandSets_{};
+        islands::IslandPartition islandPartition_{};
+        islands::ColorPartition colorPartition_{};
+        SolveSchedule solveSchedule_{};
+        collision::SolverBodies solverBodies_{};
+        collision::ContactConstraints contactConstraints_{};
+        std::vector<std::uint32_t> solverIndexOfBody_{};
+
+        // Bodies that move this substep: awake dynamic bodies plus static bodies with a velocity.
+        // Every per-body phase runs over this list; sleeping and resting static bodies are inert.
+        std::vector<std::size_t> awakeBodies_{};
+        std::vector<std::uint32_t> sleepIslandOfBody_{};
+        std::vector<std::size_t> sleepIslandMembers_{};
+        std::vector<SleepIsland> sleepIslands_{};
+        std::size_t sleepingIslandCount_ = 0;
+        std::size_t sleepingBodyCount_ = 0;
+        broadphase::InertSet inertSet_{};
+        std::vector<InertSnapshot> inertSnapshots_{};
+        bool inertSetDirty_ = true;
+        std::vector<std::uint32_t> awakeSlotOfBody_{};
+        std::vector<MaterialPair> materialPairs_{};
+        std::size_t materialPairCount_ = 0;
+        GravityArrays gravityTargets_{};
+        GravityArrays gravitySources_{};
+        std::unique_ptr<StepScratch> scratch_ = std::make_unique<StepScratch>();
+        // Both return the bodies they stepped: awake ones once this step's wakes are in, before
+        // any fall asleep at its end. stepSmall_ steps each of them smallSteps times.
+        std::size_t stepSingle_(Real dt);
+        std::size_t stepSmall_(Real dt);
+        void gatherSmallStepPairs_(Real dt, broadphase::PairList& outPairs);
+        void prepareSmallStepConstraints_(std::span<const ActiveCollisionPair> pairs, int substeps);
+        void integrateSmallStepVelocities_(Real h);
+        void advanceSmallStepPositions_(Real h);
+        void storeSmallStepContacts_(std::span<const ActiveCollisionPair> pairs, int substeps);
         void prepareForces_();
+        void clearForceRange_(std::size_t begin, std::size_t end); // Ranges index awakeBodies_
         void computeForces_();
-        void integrateVelocities_(double dt);
-        void advancePositions_(double dt);
-        void moveBodiesWithCCD_(double dt);
-        [[nodiscard]] int computeSubstepCount_(double dt) const;
-        void sanitizeBody_(Body& b);
+        void integrateVelocities_(Real dt);
+        void integrateVelocityRange_(Real dt, std::size_t begin, std::size_t end);
+        void advancePositions_(Real dt);
+        void moveBodiesWithCCD_(Real dt);
+        [[nodiscard]] int computeSubstepCount_(Real dt);
+        [[nodiscard]] Real adaptiveTimeScale_(bool& touching) const;
+        [[nodiscard]] Real predictedTimeScale_(Real dt);
+        void recordSubstep_(Real substepDt, int count, StepStats& stats);
+        bool sanitizeBody_(Body& b); // True if anything was repaired
         void sanitizeBodies_();
-        void updateSleepState_(double dt);
+        void sanitizeBodyRange_(bool full, std::size_t begin, std::size_t end);
+        void updateSleepState_(Real dt);
+        void linkSleepCandidates_(Real dt);
+        void settleSleepIslands_();
 
-        static void wakeBody_(Body& b);
-        void applyGravityPair_(std::size_t i, std::size_t j);
+        void refreshActivity_(bool bodiesEdited); // False skips re-syncing body ids
+        void stepOnce_(Real dt, bool first, StepStats& stats);
+        [[nodiscard]] const broadphase::InertSet& inertBodies_();
+        void wakeBody_(std::size_t i);
+        void wakeSleepIsland_(std::uint32_t island);
+        void wakeAllSleepIslands_();
+        void putIslandToSleep_(std::span<const std::size_t> members);
+        void compactSleepIslands_();
+        void accumulateGravity_(const GravityArrays& sources, bool mutual);
 
         void collidePairs_(
-            const std::vector<std::pair<std::size_t, std::size_t>>& pairs,
+            std::span<const broadphase::Pair> pairs,
             int velocityIterations,
             int positionIterations);
+        void buildSolveSchedule_(
+            std::span<const broadphase::Pair> pairs,
+            std::pmr::vector<ActiveCollisionPair>& activePairs);
+        // Pass over pair rows [begin, end); conflictFree is set when no dynamic body repeats in the range.
+        using SolvePassFn = std::function<void(std::size_t begin, std::size_t end, bool conflictFree)>;
+
+        void appendColorBatches_(std::pmr::vector<ActiveCollisionPair>& activePairs, std::size_t begin, std::size_t end);
+        void runSolveSchedule_(int iterations, const SolvePassFn& pass);
+        [[nodiscard]] int contactSolverLanes_() const;
+        [[nodiscard]] collision::ImpulseMode contactImpulseMode_() const;
+        void prepareContactConstraints_(std::span<const ActiveCollisionPair> pairs);
+        void solvePositionPass_(std::span<ActiveCollisionPair> pairs);
+        [[nodiscard]] jobs::JobSystem& jobSystem_();
         [[nodiscard]] ContactKey contactKeyForPair_(std::size_t i, std::size_t j) const;
         [[nodiscard]] collision::SolveParams solveParamsForPair_(std::size_t i, std::size_t j) const;
-        void assignBodyId_(Body& b);
+        void refreshMaterialPairs_();
+        void assignBodyId_(Body& b, std::size_t index);
+        void syncBodySlots_();
+        void resizeBodyState_();
+        void wakeBodiesTouching_(std::size_t index);
+        void reorderBodiesIfDue_();
+        void reorderBodies_();
         void initBodies_();
+        void updateStateHash_();
+        void markContactTouched_(ContactManifold& manifold, std::size_t i, std::size_t j);
         void beginContactFrame_();
         void warmStartPairs_(std::span<const ActiveCollisionPair> pairs);
         void endContactFrame_();
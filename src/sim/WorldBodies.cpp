@@ -0,0 +1,355 @@
+#include "World.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace sim {
+    namespace {
+        constexpr std::uint64_t kSlotMask = 0xffffffffULL;
+
+        [[nodiscard]] std::size_t slotOfId(const std::uint64_t id) {
+            return static_cast<std::size_t>(id & kSlotMask);
+        }
+
+        [[nodiscard]] std::uint32_t generationOfId(const std::uint64_t id) {
+            return static_cast<std::uint32_t>(id >> 32);
+        }
+
+        constexpr std::uint64_t kMortonAxisMax = (1ULL << 21) - 1;
+
+        // Spreads the low 21 bits of v so that two zero bits follow each one.
+        [[nodiscard]] std::uint64_t spreadMortonBits(std::uint64_t v) {
+            v &= kMortonAxisMax;
+            v = (v | v << 32) & 0x1f00000000ffffULL;
+            v = (v | v << 16) & 0x1f0000ff0000ffULL;
+            v = (v | v << 8) & 0x100f00f00f00f00fULL;
+            v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+            v = (v | v << 2) & 0x1249249249249249ULL;
+            return v;
+        }
+
+        [[nodiscard]] std::uint64_t quantize(const Real value, const Real low, const Real scale) {
+            const Real q = std::clamp<Real>((value - low) * scale, 0.0, static_cast<Real>(kMortonAxisMax));
+            return static_cast<std::uint64_t>(q);
+        }
+
+        template <typename Values>
+        void gatherByIndex(Values& values, const std::span<const std::size_t> order) {
+            Values gathered;
+            gathered.reserve(values.size());
+            for (const std::size_t from : order) {
+                gathered.push_back(values[from]);
+            }
+            values.swap(gathered);
+        }
+
+        [[nodiscard]] std::uint64_t mixHash(std::uint64_t h, const std::uint64_t value) {
+            h = (h ^ value) * 0xbf58476d1ce4e5b9ULL;
+            return h ^ (h >> 31);
+        }
+
+        [[nodiscard]] std::uint64_t realBits(const Real value) {
+            using Bits = std::conditional_t<sizeof(Real) == sizeof(std::uint64_t), std::uint64_t, std::uint32_t>;
+            return std::bit_cast<Bits>(value);
+        }
+
+        // Exact bits on purpose: two runs agree only if every field is bit-identical.
+        [[nodiscard]] std::uint64_t hashBody(const Body& b) {
+            const Real fields[] = {
+                b.position.x, b.position.y, b.position.z,
+                b.orientation.w, b.orientation.x, b.orientation.y, b.orientation.z,
+                b.velocity.x, b.velocity.y, b.velocity.z,
+                b.angularVelocity.x, b.angularVelocity.y, b.angularVelocity.z,
+                b.sleepTimer,
+            };
+            std::uint64_t h = mixHash(0x9e3779b97f4a7c15ULL, b.id);
+            for (const Real field : fields) {
+                h = mixHash(h, realBits(field));
+            }
+            return mixHash(h, b.sleeping ? 1 : 0);
+        }
+    } // namespace
+
+    std::size_t World::indexOf(const std::uint64_t id) const
+    {
+        const std::size_t slot = slotOfId(id);
+        if (slot >= bodySlots_.size()) {
+            return kNoBody;
+        }
+        const BodySlot& entry = bodySlots_[slot];
+        // The id check also catches bodies reordered through bodies() since the last step.
+        if (entry.generation != generationOfId(id) || entry.index >= bodies_.size() ||
+            bodies_[entry.index].id != id) {
+            return kNoBody;
+        }
+        return entry.index;
+    }
+
+    bool World::removeBody(const std::uint64_t id)
+    {
+        const std::size_t index = indexOf(id);
+        if (index == kNoBody) {
+            return false;
+        }
+        resizeBodyState_();
+        wakeBodiesTouching_(index);
+
+        // Swap-and-pop: the last body and its per-body state move into the hole. Contact
+        // manifolds are keyed by id, so the cache follows the move without being touched.
+        const std::size_t last = bodies_.size() - 1;
+        if (index != last) {
+            bodies_[index] = bodies_[last];
+            forces_[index] = forces_[last];
+            contactTouchedBodies_[index] = contactTouchedBodies_[last];
+            inertSnapshots_[index] = inertSnapshots_[last];
+            const std::uint32_t island = sleepIslandOfBody_[last];
+            sleepIslandOfBody_[index] = island;
+            if (island != kNoSleepIsland) {
+                const SleepIsland& range = sleepIslands_[island];
+                const auto members = sleepIslandMembers_.begin();
+                std::replace(
+                    members + static_cast<std::ptrdiff_t>(range.begin),
+                    members + static_cast<std::ptrdiff_t>(range.end),
+                    last,
+                    index);
+            }
+            const std::size_t movedSlot = slotOfId(bodies_[index].id);
+            if (movedSlot < bodySlots_.size() && bodySlots_[movedSlot].generation == generationOfId(bodies_[index].id)) {
+                bodySlots_[movedSlot].index = static_cast<std::uint32_t>(index);
+            }
+        }
+        bodies_.pop_back();
+        forces_.pop_back();
+        contactTouchedBodies_.pop_back();
+        inertSnapshots_.pop_back();
+        sleepIslandOfBody_.pop_back();
+
+        const std::size_t slot = slotOfId(id);
+        bodySlots_[slot].index = kFreeBodySlot;
+        freeBodySlots_.push_back(static_cast<std::uint32_t>(slot));
+        inertSetDirty_ = true;
+        stateHashValid_ = false;
+        forcesStale_ = true;
+        return true;
+    }
+
+    void World::wakeBodiesTouching_(const std::size_t index)
+    {
+        // Bodies resting on a removed one must not stay asleep in mid-air.
+        if (sleepingBodyCount_ == 0) {
+            return;
+        }
+        const Body& body = bodies_[index];
+        const Real reach = body.radius + std::max<Real>(0.0, params_.penetrationSlop);
+        auto& touching = scratch_->overlapPairs;
+        touching.clear();
+        if (std::isfinite(reach) && std::isfinite(body.position.x) && std::isfinite(body.position.y) &&
+            std::isfinite(body.position.z)) {
+            const broadphase::AxisInterval bounds{
+                .idx = index,
+                .minX = body.position.x - reach,
+                .maxX = body.position.x + reach,
+                .minY = body.position.y - reach,
+                .maxY = body.position.y + reach,
+                .minZ = body.position.z - reach,
+                .maxZ = body.position.z + reach,
+            };
+            inertBodies_().appendOverlaps(bodies_, bounds, touching);
+        }
+        wakeBody_(index);
+        for (const auto& [i, j] : touching) {
+            wakeBody_(i == index ? j : i);
+        }
+    }
+
+    std::span<const std::size_t> World::previousBodyIndices() const { return previousBodyIndices_; }
+    std::uint64_t World::reorderCount() const { return reorderCount_; }
+
+    void World::reorderBodiesIfDue_()
+    {
+        if (params_.reorderInterval <= 0) {
+            stepsSinceReorder_ = 0;
+            return;
+        }
+        if (++stepsSinceReorder_ < static_cast<std::size_t>(params_.reorderInterval)) {
+            return;
+        }
+        stepsSinceReorder_ = 0;
+        reorderBodies_();
+    }
+
+    void World::reorderBodies_()
+    {
+        const std::size_t count = bodies_.size();
+        if (count < 2) {
+            return;
+        }
+
+        Vec3 low(std::numeric_limits<Real>::max(), std::numeric_limits<Real>::max(), std::numeric_limits<Real>::max());
+        Vec3 high(-low.x, -low.y, -low.z);
+        const auto finitePosition = [](const Vec3& p) {
+            return std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z);
+        };
+        for (const Body& body : bodies_) {
+            if (finitePosition(body.position)) {
+                low = Vec3(std::min(low.x, body.position.x), std::min(low.y, body.position.y), std::min(low.z, body.position.z));
+                high = Vec3(std::max(high.x, body.position.x), std::max(high.y, body.position.y), std::max(high.z, body.position.z));
+            }
+        }
+        const auto axisScale = [](const Real extent) {
+            return extent > Real(0.0) ? static_cast<Real>(kMortonAxisMax) / extent : Real(0.0);
+        };
+        const Vec3 scale(axisScale(high.x - low.x), axisScale(high.y - low.y), axisScale(high.z - low.z));
+
+        // Ties keep their current relative order, so a settled scene sorts to the same order again.
+        auto& keys = scratch_->sortKeys;
+        keys.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            const Vec3& p = bodies_[i].position;
+            std::uint64_t key = std::numeric_limits<std::uint64_t>::max();
+            if (finitePosition(p)) {
+                key = spreadMortonBits(quantize(p.x, low.x, scale.x)) |
+                      spreadMortonBits(quantize(p.y, low.y, scale.y)) << 1 |
+                      spreadMortonBits(quantize(p.z, low.z, scale.z)) << 2;
+            }
+            keys.emplace_back(key, i);
+        }
+        std::ranges::sort(keys);
+        bool moved = false;
+        for (std::size_t i = 0; i < count && !moved; ++i) {
+            moved = keys[i].second != i;
+        }
+        if (!moved) {
+            return;
+        }
+
+        previousBodyIndices_.resize(count);
+        auto& newIndexOf = scratch_->newIndexOf;
+        newIndexOf.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            previousBodyIndices_[i] = keys[i].second;
+            newIndexOf[keys[i].second] = i;
+        }
+
+        // Everything indexed by body moves with it. Contact manifolds are keyed by id, and the
+        // render interpolation state (prevPosition, prevOrientation) lives in Body.
+        gatherByIndex(bodies_, previousBodyIndices_);
+        gatherByIndex(forces_, previousBodyIndices_);
+        gatherByIndex(contactTouchedBodies_, previousBodyIndices_);
+        gatherByIndex(sleepIslandOfBody_, previousBodyIndices_);
+        gatherByIndex(inertSnapshots_, previousBodyIndices_);
+        for (std::size_t& member : sleepIslandMembers_) {
+            member = newIndexOf[member];
+        }
+        for (std::size_t& i : awakeBodies_) {
+            i = newIndexOf[i];
+        }
+        std::ranges::sort(awakeBodies_);
+        for (std::size_t i = 0; i < count; ++i) {
+            bodySlots_[slotOfId(bodies_[i].id)].index = static_cast<std::uint32_t>(i);
+        }
+        inertSetDirty_ = true;
+        stateHashValid_ = false;
+        ++reorderCount_;
+    }
+
+    void World::assignBodyId_(Body& b, const std::size_t index)
+    {
+        std::uint32_t slot = 0;
+        if (!freeBodySlots_.empty()) {
+            slot = freeBodySlots_.back();
+            freeBodySlots_.pop_back();
+        } else {
+            slot = static_cast<std::uint32_t>(bodySlots_.size());
+            bodySlots_.emplace_back();
+        }
+        BodySlot& entry = bodySlots_[slot];
+        // Generation 0 is never handed out, so id 0 stays "unassigned".
+        if (++entry.generation == 0) {
+            entry.generation = 1;
+        }
+        entry.index = static_cast<std::uint32_t>(index);
+        b.id = (static_cast<std::uint64_t>(entry.generation) << 32) | slot;
+    }
+
+    void World::syncBodySlots_()
+    {
+        // Callers may add, drop or reorder bodies through bodies(). Bodies whose ids still name
+        // their slot keep them; the rest (copies, fresh bodies with id 0) get new ids.
+        bool inSync = bodySlots_.size() - freeBodySlots_.size() == bodies_.size();
+        for (std::size_t i = 0; inSync && i < bodies_.size(); ++i) {
+            inSync = indexOf(bodies_[i].id) == i;
+        }
+        if (inSync) {
+            return;
+        }
+
+        for (BodySlot& entry : bodySlots_) {
+            entry.index = kFreeBodySlot;
+        }
+        auto& unassigned = scratch_->unassignedBodies;
+        unassigned.clear();
+        for (std::size_t i = 0; i < bodies_.size(); ++i) {
+            const std::uint64_t id = bodies_[i].id;
+            const std::size_t slot = slotOfId(id);
+            if (slot < bodySlots_.size() && bodySlots_[slot].generation == generationOfId(id) &&
+                bodySlots_[slot].index == kFreeBodySlot) {
+                bodySlots_[slot].index = static_cast<std::uint32_t>(i);
+            } else {
+                unassigned.push_back(i);
+            }
+        }
+        freeBodySlots_.clear();
+        for (std::size_t slot = bodySlots_.size(); slot-- > 0;) {
+            if (bodySlots_[slot].index == kFreeBodySlot) {
+                freeBodySlots_.push_back(static_cast<std::uint32_t>(slot));
+            }
+        }
+        for (const std::size_t i : unassigned) {
+            assignBodyId_(bodies_[i], i);
+        }
+    }
+
+    std::uint64_t World::stateHash() const
+    {
+        if (stateHashValid_) {
+            return stateHash_;
+        }
+        std::uint64_t hash = 0;
+        for (const Body& body : bodies_) {
+            hash += hashBody(body);
+        }
+        return hash;
+    }
+
+    void World::updateStateHash_()
+    {
+        // Only bodies that were awake at some point of the step can have changed; everything
+        // else keeps the hash it had.
+        if (!stateHashValid_ || bodyHashes_.size() != bodies_.size()) {
+            bodyHashes_.resize(bodies_.size());
+            stateHash_ = 0;
+            for (std::size_t i = 0; i < bodies_.size(); ++i) {
+                bodyHashes_[i] = hashBody(bodies_[i]);
+                stateHash_ += bodyHashes_[i];
+            }
+            stateHashValid_ = true;
+            return;
+        }
+        const auto refresh = [this](const std::size_t i) {
+            const std::uint64_t hash = hashBody(bodies_[i]);
+            stateHash_ += hash - bodyHashes_[i];
+            bodyHashes_[i] = hash;
+        };
+        for (const std::size_t i : scratch_->movedBodies) {
+            refresh(i);
+        }
+        for (const std::size_t i : awakeBodies_) {
+            refresh(i);
+        }
+    }
+
+} // namespace sim
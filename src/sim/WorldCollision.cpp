@@ -2,31 +2,45 @@
 
 #include "Broadphase.h"
 #include "Collision.h"
+#include "ContactSolver.h"
+#include "Material.h"
 
 #include <algorithm>
 #include <cmath>
 #include <limits>
-#include <ranges>
 
 namespace sim {
-
-    void World::moveBodiesWithCCD_(const double dt)
+    namespace {
+        // Below this many pairs the island build and dispatch cost more than solving serially.
+        constexpr std::size_t kMinParallelContactPairs = 64;
+        // Islands at least this large are graph-colored and solved color by color in parallel.
+        constexpr std::size_t kMinColoredIslandPairs = 256;
+        // Multiple of the widest lane count so parallel chunks split on lane-group boundaries.
+        constexpr std::size_t kColorBatchGrain = 64;
+    } // namespace
+
+    void World::moveBodiesWithCCD_(const Real dt)
     {
         if (!params_.enableCollisions) {
             advancePositions_(dt);
             return;
         }
 
-        double remaining = dt;
-        constexpr double machineEps = std::numeric_limits<double>::epsilon();
-        const double timeTol = machineEps * std::max(1.0, std::abs(dt));
+        // Nothing moves, so no pair can change: a world at rest skips collision entirely.
+        if (awakeBodies_.empty()) {
+            return;
+        }
+
+        Real remaining = dt;
+        constexpr Real machineEps = std::numeric_limits<Real>::epsilon();
+        const Real timeTol = machineEps * std::max<Real>(1.0, std::abs(dt));
         if (remaining <= timeTol) {
             return;
         }
 
-        thread_local std::vector<broadphase::Pair> sweptPairs;
-        thread_local std::vector<broadphase::Pair> overlapPairs;
-        thread_local std::vector<std::pair<std::size_t, std::size_t>> zeroTimeOverlapPairs;
+        auto& sweptPairs = scratch_->sweptPairs;
+        auto& overlapPairs = scratch_->overlapPairs;
+        auto& zeroTimeOverlapPairs = scratch_->collidingPairs;
         const int maxCcdIterations = std::max(1, params_.maxCcdIterationsPerStep);
         const int maxRepeatedZeroToiPairs = std::max(1, params_.maxRepeatedZeroToiPairs);
         ContactKey lastZeroToiKey{};
@@ -38,11 +52,13 @@ namespace sim {
             ++ccdIterations;
             if (ccdIterations > maxCcdIterations) {
                 advancePositions_(remaining);
-                broadphase::discretePairs(bodies_, overlapPairs);
+                broadphase::discretePairs(bodies_, awakeBodies_, inertBodies_(), scratch_->broadphase, overlapPairs);
                 zeroTimeOverlapPairs.clear();
                 zeroTimeOverlapPairs.reserve(overlapPairs.size());
                 for (const auto& [i, j] : overlapPairs) {
                     if (collision::isColliding(bodies_[i], bodies_[j])) {
+                        wakeBody_(i);
+                        wakeBody_(j);
                         zeroTimeOverlapPairs.emplace_back(i, j);
                     }
                 }
@@ -52,20 +68,20 @@ namespace sim {
                 break;
             }
 
-            broadphase::sweptPairs(bodies_, remaining, sweptPairs);
+            broadphase::sweptPairs(bodies_, awakeBodies_, inertBodies_(), remaining, scratch_->broadphase, sweptPairs);
 
             bool found = false;
-            double tHit = std::numeric_limits<double>::infinity();
+            Real tHit = std::numeric_limits<Real>::infinity();
             std::size_t toiI = 0;
             std::size_t toiJ = 0;
             for (const auto& [i, j] : sweptPairs) {
                 const Body& A = bodies_[i];
                 const Body& B = bodies_[j];
-                if (A.invMass == 0.0 && B.invMass == 0.0) {
+                if (A.invMass == Real(0.0) && B.invMass == Real(0.0)) {
                     continue;
                 }
 
-                double t = 0.0;
+                Real t = 0.0;
                 if (!collision::sweptCollisionTime(A, B, remaining, t)) {
                     continue;
                 }
@@ -84,10 +100,10 @@ namespace sim {
 
             bool advancedToToi = false;
             if (tHit > timeTol) {
-                const double consumeToToi = std::min(tHit, remaining);
+                const Real consumeToToi = std::min(tHit, remaining);
                 if (consumeToToi > timeTol) {
                     advancePositions_(consumeToToi);
-                    remaining = std::max(0.0, remaining - consumeToToi);
+                    remaining = std::max<Real>(0.0, remaining - consumeToToi);
                     advancedToToi = true;
                     lastZeroToiKeyValid = false;
                     repeatedZeroToiPairs = 0;
@@ -105,41 +121,45 @@ namespace sim {
                 }
             }
 
+            // Sleeping islands wake on first contact, before anything is applied to them.
+            wakeBody_(toiI);
+            wakeBody_(toiJ);
             const auto toiStats = collision::solveCollisionPair(
                 bodies_[toiI], bodies_[toiJ], solveParamsForPair_(toiI, toiJ), true);
-            if (toiStats.impulseApplied) {
-                wakeBody_(bodies_[toiI]);
-                wakeBody_(bodies_[toiJ]);
-            }
 
             if (toiStats.hasNormal) {
                 ContactManifold& manifold = contactCache_[contactKeyForPair_(toiI, toiJ)];
-                manifold.touched = true;
-                manifold.staleFrames = 0;
+                markContactTouched_(manifold, toiI, toiJ);
                 manifold.normal = toiStats.normal;
-                if (toiStats.normalImpulse > 0.0) {
+                if (params_.accumulateContactImpulses) {
+                    // Exact totals stay as they are; the TOI impulse only joins them once they are
+                    // part of the velocities, so the next solve can still take it back.
+                    if (manifold.appliedThisFrame) {
+                        manifold.normalImpulse += std::max<Real>(0.0, toiStats.normalImpulse);
+                    }
+                } else if (toiStats.normalImpulse > Real(0.0)) {
                     manifold.normalImpulse = toiStats.normalImpulse;
                 } else {
-                    manifold.normalImpulse *= 0.9;
+                    manifold.normalImpulse *= Real(0.9);
                 }
-                if (std::abs(toiStats.tangentImpulse) > 0.0) {
+                if (std::abs(toiStats.tangentImpulse) > Real(0.0)) {
                     manifold.tangentImpulse = toiStats.tangentImpulse;
                 } else {
-                    manifold.tangentImpulse *= 0.8;
+                    manifold.tangentImpulse *= Real(0.8);
                 }
-                contactTouchedBodies_[toiI] = true;
-                contactTouchedBodies_[toiJ] = true;
             }
-            broadphase::discretePairs(bodies_, overlapPairs);
+            broadphase::discretePairs(bodies_, awakeBodies_, inertBodies_(), scratch_->broadphase, overlapPairs);
             zeroTimeOverlapPairs.clear();
             zeroTimeOverlapPairs.reserve(overlapPairs.size());
             for (const auto& [i, j] : overlapPairs) {
                 const Body& A = bodies_[i];
                 const Body& B = bodies_[j];
-                if (A.invMass == 0.0 && B.invMass == 0.0) {
+                if (A.invMass == Real(0.0) && B.invMass == Real(0.0)) {
                     continue;
                 }
                 if (collision::isColliding(A, B)) {
+                    wakeBody_(i);
+                    wakeBody_(j);
                     zeroTimeOverlapPairs.emplace_back(i, j);
                 }
             }
@@ -150,14 +170,14 @@ namespace sim {
 
             if (!advancedToToi) {
                 // Ensure forward progress for repeated zero-time TOI contacts.
-                const double repeatedPairBoost =
-                    repeatedZeroToiPairs >= maxRepeatedZeroToiPairs ? std::max(1.0, static_cast<double>(repeatedZeroToiPairs)) : 1.0;
-                const double minConsume =
-                    std::max(timeTol * 32.0, (std::max(0.0, dt) / 128.0) * repeatedPairBoost);
-                const double consume = std::min(remaining, minConsume);
-                if (consume > 0.0) {
+                const Real repeatedPairBoost =
+                    repeatedZeroToiPairs >= maxRepeatedZeroToiPairs ? std::max<Real>(1.0, static_cast<Real>(repeatedZeroToiPairs)) : Real(1.0);
+                const Real minConsume =
+                    std::max<Real>(timeTol * Real(32.0), (std::max<Real>(0.0, dt) / Real(128.0)) * repeatedPairBoost);
+                const Real consume = std::min(remaining, minConsume);
+                if (consume > Real(0.0)) {
                     advancePositions_(consume);
-                    remaining = std::max(0.0, remaining - consume);
+                    remaining = std::max<Real>(0.0, remaining - consume);
                 } else {
                     break;
                 }
@@ -166,7 +186,7 @@ namespace sim {
     }
 
     void World::collidePairs_(
-        const std::vector<std::pair<std::size_t, std::size_t>>& pairs,
+        const std::span<const broadphase::Pair> pairs,
         const int velocityIterations,
         const int positionIterations)
     {
@@ -174,7 +194,7 @@ namespace sim {
             return;
         }
 
-        thread_local std::vector<ActiveCollisionPair> activePairs;
+        auto& activePairs = scratch_->activePairs;
         activePairs.clear();
         activePairs.reserve(pairs.size());
         for (const auto& [i, j] : pairs) {
@@ -189,37 +209,56 @@ namespace sim {
             return;
         }
 
-        warmStartPairs_(activePairs);
+        const collision::ImpulseMode impulseMode = contactImpulseMode_();
+        if (impulseMode == collision::ImpulseMode::PerIteration) {
+            warmStartPairs_(activePairs);
+        }
+        buildSolveSchedule_(pairs, activePairs);
+
+        // Spans, not the scratch vector itself: passes run on worker threads.
+        const std::span<ActiveCollisionPair> ordered(activePairs);
+        // Split impulse folds position correction into the velocity iterations below.
+        const bool splitImpulse = params_.splitImpulse && velocityIterations > 0;
+        if (!splitImpulse) {
+            const int positionPasses = positionIterations > 0 ? positionIterations : 1;
+            runSolveSchedule_(positionPasses, [this, ordered](const std::size_t begin, const std::size_t end, bool) {
+                solvePositionPass_(ordered.subspan(begin, end - begin));
+            });
+        }
 
-        for (int it = 0; it < positionIterations; ++it) {
-            for (auto& pair : activePairs) {
-                auto positionParams = pair.params;
-                positionParams.applyVelocityImpulse = false;
-                positionParams.applyFrictionImpulse = false;
-                positionParams.applyPositionCorrection = true;
-                collision::solveCollisionPair(
-                    bodies_[pair.i], bodies_[pair.j], positionParams, false);
+        if (velocityIterations > 0) {
+            prepareContactConstraints_(ordered);
+            const auto lanes = static_cast<std::size_t>(contactSolverLanes_());
+            runSolveSchedule_(velocityIterations, [this, lanes, impulseMode, splitImpulse](
+                const std::size_t begin, const std::size_t end, const bool conflictFree) {
+                if (conflictFree && lanes > 1) {
+                    collision::solveContactVelocitiesWide(
+                        contactConstraints_, solverBodies_, begin, end, lanes, impulseMode, splitImpulse);
+                } else {
+                    collision::solveContactVelocities(
+                        contactConstraints_, solverBodies_, begin, end, impulseMode, splitImpulse);
+                }
+            });
+            solverBodies_.scatter(bodies_);
+            if (splitImpulse) {
+                solverBodies_.applyDisplacement(bodies_);
             }
-        }
 
-        for (int it = 0; it < velocityIterations; ++it) {
-            for (auto& pair : activePairs) {
-                auto velocityParams = pair.params;
-                velocityParams.applyPositionCorrection = (it == 0 && positionIterations == 0);
-                velocityParams.applyVelocityImpulse = true;
-                velocityParams.applyFrictionImpulse = true;
-                const auto stats = collision::solveCollisionPair(
-                    bodies_[pair.i], bodies_[pair.j], velocityParams, false);
-                if (stats.hasNormal && stats.normalImpulse > 0.0) {
-                    pair.accumulatedImpulse += stats.normalImpulse;
+            for (std::size_t k = 0; k < activePairs.size(); ++k) {
+                ActiveCollisionPair& pair = activePairs[k];
+                if (contactConstraints_.active[k] == 0) {
+                    continue;
                 }
-                if (stats.hasNormal) {
-                    contactTouchedBodies_[pair.i] = true;
-                    contactTouchedBodies_[pair.j] = true;
-                    if (stats.impulseApplied) {
-                        wakeBody_(bodies_[pair.i]);
-                        wakeBody_(bodies_[pair.j]);
-                    }
+                pair.accumulatedImpulse = contactConstraints_.normalImpulse[k];
+                pair.accumulatedFriction = Vec3(
+                    contactConstraints_.frictionImpulseX[k],
+                    contactConstraints_.frictionImpulseY[k],
+                    contactConstraints_.frictionImpulseZ[k]);
+                contactTouchedBodies_[pair.i] = true;
+                contactTouchedBodies_[pair.j] = true;
+                if (contactConstraints_.impulseApplied[k] != 0) {
+                    wakeBody_(pair.i);
+                    wakeBody_(pair.j);
                 }
             }
         }
@@ -230,15 +269,19 @@ namespace sim {
             }
 
             ContactManifold& manifold = contactCache_[pair.key];
-            manifold.touched = true;
-            manifold.staleFrames = 0;
-            contactTouchedBodies_[pair.i] = true;
-            contactTouchedBodies_[pair.j] = true;
-
-            if (pair.accumulatedImpulse > 0.0) {
+            markContactTouched_(manifold, pair.i, pair.j);
+
+            if (impulseMode == collision::ImpulseMode::Accumulated) {
+                // Exact totals: the next solve of this pair starts from them instead of from zero.
+                if (velocityIterations > 0) {
+                    manifold.normalImpulse = pair.accumulatedImpulse;
+                    manifold.frictionImpulse = pair.accumulatedFriction;
+                    manifold.appliedThisFrame = true;
+                }
+            } else if (pair.accumulatedImpulse > Real(0.0)) {
                 manifold.normalImpulse = pair.accumulatedImpulse;
             } else {
-                manifold.normalImpulse *= 0.9;
+                manifold.normalImpulse *= Real(0.9);
             }
             Vec3 normal{};
             if (collision::contactNormal(bodies_[pair.i], bodies_[pair.j], normal)) {
@@ -247,6 +290,184 @@ namespace sim {
         }
     }
 
+    void World::buildSolveSchedule_(
+        const std::span<const broadphase::Pair> pairs,
+        std::pmr::vector<ActiveCollisionPair>& activePairs)
+    {
+        SolveSchedule& schedule = solveSchedule_;
+        schedule.islandRanges.clear();
+        schedule.colorBatches.clear();
+
+        // Lane batches need conflict-free rows, so the wide solver colors every pair.
+        if (contactSolverLanes_() > 1) {
+            appendColorBatches_(activePairs, 0, activePairs.size());
+            return;
+        }
+
+        // Coloring reorders the solve, so deterministic mode partitions the same way for every
+        // pool size, including a single thread.
+        const jobs::JobSystem& jobs = jobSystem_();
+        const bool partition = params_.deterministic || jobs.threadCount() > 1;
+        if (!partition || activePairs.size() < kMinParallelContactPairs) {
+            schedule.islandRanges.emplace_back(0, activePairs.size());
+            return;
+        }
+
+        islands::buildPairIslands(bodies_, pairs, islandSets_, scratch_->partition, islandPartition_);
+        auto& reordered = scratch_->reorderedPairs;
+        reordered.clear();
+        reordered.reserve(activePairs.size());
+        for (const std::size_t index : islandPartition_.pairOrder) {
+            reordered.push_back(activePairs[index]);
+        }
+        activePairs.swap(reordered);
+
+        // Small islands run one per task; large islands are colored and parallelized internally.
+        const auto& offsets = islandPartition_.islandOffsets;
+        for (std::size_t k = 0; k < islandPartition_.islandCount(); ++k) {
+            const std::size_t begin = offsets[k];
+            const std::size_t end = offsets[k + 1];
+            if (end - begin < kMinColoredIslandPairs) {
+                schedule.islandRanges.emplace_back(begin, end);
+            } else {
+                appendColorBatches_(activePairs, begin, end);
+            }
+        }
+    }
+
+    void World::appendColorBatches_(
+        std::pmr::vector<ActiveCollisionPair>& activePairs,
+        const std::size_t begin,
+        const std::size_t end)
+    {
+        auto& bodyPairs = scratch_->bodyPairs;
+        bodyPairs.clear();
+        for (std::size_t p = begin; p < end; ++p) {
+            bodyPairs.emplace_back(activePairs[p].i, activePairs[p].j);
+        }
+        islands::buildPairColors(bodies_, bodyPairs, scratch_->partition, colorPartition_);
+
+        auto& original = scratch_->originalPairs;
+        original.assign(activePairs.begin() + static_cast<std::ptrdiff_t>(begin),
+            activePairs.begin() + static_cast<std::ptrdiff_t>(end));
+        for (std::size_t c = 0; c < colorPartition_.pairOrder.size(); ++c) {
+            activePairs[begin + c] = original[colorPartition_.pairOrder[c]];
+        }
+
+        const std::size_t colorCount = colorPartition_.colorCount();
+        for (std::size_t c = 0; c < colorCount; ++c) {
+            solveSchedule_.colorBatches.push_back(ColorBatch{
+                .begin = begin + colorPartition_.colorOffsets[c],
+                .end = begin + colorPartition_.colorOffsets[c + 1],
+                .serial = colorPartition_.overflowColor && c + 1 == colorCount,
+            });
+        }
+    }
+
+    void World::runSolveSchedule_(const int iterations, const SolvePassFn& pass)
+    {
+        if (iterations <= 0) {
+            return;
+        }
+
+        const SolveSchedule& schedule = solveSchedule_;
+        jobs::JobSystem& jobs = jobSystem_();
+        const auto& islandRanges = schedule.islandRanges;
+        const std::size_t grain =
+            std::max<std::size_t>(1, islandRanges.size() / (static_cast<std::size_t>(jobs.threadCount()) * 4));
+        jobs.parallelFor(islandRanges.size(), grain, [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) {
+                for (int it = 0; it < iterations; ++it) {
+                    pass(islandRanges[k].first, islandRanges[k].second, false);
+                }
+            }
+        });
+
+        // Colors share bodies with each other, so every color batch is a barrier.
+        for (int it = 0; it < iterations; ++it) {
+            for (const ColorBatch& batch : schedule.colorBatches) {
+                if (batch.serial) {
+                    pass(batch.begin, batch.end, false);
+                    continue;
+                }
+                jobs.parallelFor(batch.end - batch.begin, kColorBatchGrain, [&](const std::size_t begin, const std::size_t end) {
+                    pass(batch.begin + begin, batch.begin + end, true);
+                });
+            }
+        }
+    }
+
+    int World::contactSolverLanes_() const
+    {
+        const int lanes = params_.contactSolverLanes;
+        return lanes >= 8 ? 8 : (lanes >= 4 ? 4 : 1);
+    }
+
+    collision::ImpulseMode World::contactImpulseMode_() const
+    {
+        return params_.accumulateContactImpulses
+            ? collision::ImpulseMode::Accumulated
+            : collision::ImpulseMode::PerIteration;
+    }
+
+    void World::prepareContactConstraints_(const std::span<const ActiveCollisionPair> pairs)
+    {
+        constexpr std::uint32_t kUnmapped = std::numeric_limits<std::uint32_t>::max();
+        solverBodies_.clear();
+        solverIndexOfBody_.assign(bodies_.size(), kUnmapped);
+        const auto solverIndex = [&](const std::size_t body) {
+            if (solverIndexOfBody_[body] == kUnmapped) {
+                solverIndexOfBody_[body] = solverBodies_.add(bodies_[body], body);
+            }
+            return solverIndexOfBody_[body];
+        };
+
+        contactConstraints_.resize(pairs.size());
+        for (std::size_t k = 0; k < pairs.size(); ++k) {
+            const ActiveCollisionPair& pair = pairs[k];
+            collision::prepareContact(
+                contactConstraints_,
+                k,
+                bodies_[pair.i],
+                bodies_[pair.j],
+                solverIndex(pair.i),
+                solverIndex(pair.j),
+                pair.params);
+        }
+
+        if (contactImpulseMode_() != collision::ImpulseMode::Accumulated) {
+            return;
+        }
+        for (std::size_t k = 0; k < pairs.size(); ++k) {
+            const ContactManifold* manifold = contactCache_.find(pairs[k].key);
+            if (manifold == nullptr) {
+                continue;
+            }
+            collision::warmStartContact(
+                contactConstraints_,
+                solverBodies_,
+                k,
+                manifold->normalImpulse,
+                manifold->frictionImpulse,
+                !manifold->appliedThisFrame);
+        }
+        for (std::size_t k = 0; k < pairs.size(); ++k) {
+            collision::updateVelocityBias(contactConstraints_, solverBodies_, k);
+        }
+    }
+
+    void World::solvePositionPass_(const std::span<ActiveCollisionPair> pairs)
+    {
+        for (auto& pair : pairs) {
+            auto positionParams = pair.params;
+            positionParams.applyVelocityImpulse = false;
+            positionParams.applyFrictionImpulse = false;
+            positionParams.applyPositionCorrection = true;
+            collision::solveCollisionPair(
+                bodies_[pair.i], bodies_[pair.j], positionParams, false);
+        }
+    }
+
     World::ContactKey World::contactKeyForPair_(const std::size_t i, const std::size_t j) const
     {
         const std::uint64_t a = bodies_[i].id;
@@ -256,47 +477,99 @@ namespace sim {
 
     collision::SolveParams World::solveParamsForPair_(const std::size_t i, const std::size_t j) const
     {
-        const Body& a = bodies_[i];
-        const Body& b = bodies_[j];
+        // Handles are validated by sanitization, but a body edited since then may still carry a
+        // bad one; those fall back to the default material like everywhere else.
+        const std::size_t count = materialPairCount_;
+        const std::size_t a = bodies_[i].material < count ? bodies_[i].material : kDefaultMaterial;
+        const std::size_t b = bodies_[j].material < count ? bodies_[j].material : kDefaultMaterial;
+        const MaterialPair& pair = materialPairs_[a * count + b];
 
         collision::SolveParams params{};
-        const double pairRestitution = std::clamp(std::min(a.restitution, b.restitution), 0.0, 1.0);
-        const double worldRestitution = std::isfinite(params_.restitution)
-            ? std::clamp(params_.restitution, 0.0, 1.0)
+        const Real worldRestitution = std::isfinite(params_.restitution)
+            ? std::clamp<Real>(params_.restitution, 0.0, 1.0)
             : Params::kDefaultRestitution;
-        params.restitution = std::min(pairRestitution, worldRestitution);
-        params.staticFriction = std::sqrt(std::max(0.0, a.staticFriction) * std::max(0.0, b.staticFriction));
-        params.dynamicFriction = std::sqrt(std::max(0.0, a.dynamicFriction) * std::max(0.0, b.dynamicFriction));
-        if (params.dynamicFriction > params.staticFriction) {
-            params.dynamicFriction = params.staticFriction;
-        }
+        params.restitution = std::min(pair.restitution, worldRestitution);
+        params.staticFriction = pair.staticFriction;
+        params.dynamicFriction = pair.dynamicFriction;
         params.penetrationSlop = params_.penetrationSlop;
         params.positionCorrectionPercent = params_.positionCorrectionPercent;
         return params;
     }
 
+    void World::refreshMaterialPairs_()
+    {
+        // The registry only grows and never edits an entry, so its size tells if the table is current.
+        const std::size_t count = materialCount();
+        if (count == materialPairCount_) {
+            return;
+        }
+
+        struct Effective {
+            Real restitution;
+            Real staticFriction;
+            Real dynamicFriction;
+        };
+        std::vector<Effective> effective(count);
+        for (std::size_t m = 0; m < count; ++m) {
+            const Material& material = materialFor(static_cast<MaterialHandle>(m));
+            Effective& e = effective[m];
+            e.restitution = std::isfinite(material.restitution)
+                ? std::clamp<Real>(material.restitution, 0.0, 1.0)
+                : defaultMaterial().restitution;
+            e.staticFriction = std::isfinite(material.staticFriction) && material.staticFriction >= Real(0.0)
+                ? material.staticFriction
+                : defaultMaterial().staticFriction;
+            e.dynamicFriction = std::isfinite(material.dynamicFriction) && material.dynamicFriction >= Real(0.0)
+                ? std::min(material.dynamicFriction, e.staticFriction)
+                : std::min(defaultMaterial().dynamicFriction, e.staticFriction);
+        }
+
+        materialPairs_.resize(count * count);
+        for (std::size_t a = 0; a < count; ++a) {
+            for (std::size_t b = 0; b < count; ++b) {
+                MaterialPair& pair = materialPairs_[a * count + b];
+                pair.restitution = std::min(effective[a].restitution, effective[b].restitution);
+                pair.staticFriction = std::sqrt(effective[a].staticFriction * effective[b].staticFriction);
+                pair.dynamicFriction = std::min(
+                    std::sqrt(effective[a].dynamicFriction * effective[b].dynamicFriction), pair.staticFriction);
+            }
+        }
+        materialPairCount_ = count;
+    }
+
+    void World::markContactTouched_(ContactManifold& manifold, const std::size_t i, const std::size_t j)
+    {
+        manifold.touched = true;
+        manifold.staleFrames = 0;
+        manifold.bodyA = i;
+        manifold.bodyB = j;
+        contactTouchedBodies_[i] = true;
+        contactTouchedBodies_[j] = true;
+    }
+
     void World::beginContactFrame_()
     {
         if (contactTouchedBodies_.size() != bodies_.size()) {
             contactTouchedBodies_.resize(bodies_.size());
         }
-        std::fill(contactTouchedBodies_.begin(), contactTouchedBodies_.end(), false);
-        for (auto& manifold : contactCache_ | std::views::values) {
-            manifold.touched = false;
+        // Only moving bodies can have been touched; sleeping ones were cleared when they woke.
+        // Manifold flags were already cleared by the previous endContactFrame_ scan.
+        for (const std::size_t i : awakeBodies_) {
+            contactTouchedBodies_[i] = false;
         }
     }
 
     void World::warmStartPairs_(const std::span<const ActiveCollisionPair> pairs)
     {
         for (const auto& pair : pairs) {
-            constexpr double kWarmStartFactor = 0.85;
-            auto it = contactCache_.find(pair.key);
-            if (it == contactCache_.end()) {
+            constexpr Real kWarmStartFactor = 0.85;
+            ContactManifold* cached = contactCache_.find(pair.key);
+            if (cached == nullptr) {
                 continue;
             }
 
-            ContactManifold& manifold = it->second;
-            if (manifold.normalImpulse <= 0.0) {
+            ContactManifold& manifold = *cached;
+            if (manifold.normalImpulse <= Real(0.0)) {
                 continue;
             }
             if (!collision::isColliding(bodies_[pair.i], bodies_[pair.j])) {
@@ -308,17 +581,17 @@ namespace sim {
                 continue;
             }
 
-            const double relativeNormalVelocity = (bodies_[pair.j].velocity - bodies_[pair.i].velocity).dot(normal);
-            if (relativeNormalVelocity > 0.0) {
+            const Real relativeNormalVelocity = (bodies_[pair.j].velocity - bodies_[pair.i].velocity).dot(normal);
+            if (relativeNormalVelocity > Real(0.0)) {
                 continue;
             }
 
             collision::applyNormalImpulse(
                 bodies_[pair.i], bodies_[pair.j], normal, manifold.normalImpulse * kWarmStartFactor);
-            if (std::abs(manifold.tangentImpulse) > 1e-8) {
+            if (std::abs(manifold.tangentImpulse) > Real(1e-8)) {
                 Vec3 tangent = (bodies_[pair.j].velocity - bodies_[pair.i].velocity) - normal * relativeNormalVelocity;
-                const double tangentLength = tangent.magnitude();
-                if (tangentLength > 1e-8) {
+                const Real tangentLength = tangent.magnitude();
+                if (tangentLength > Real(1e-8)) {
                     tangent /= tangentLength;
                     collision::applyTangentImpulse(
                         bodies_[pair.i],
@@ -328,32 +601,29 @@ namespace sim {
                         manifold.tangentImpulse * kWarmStartFactor);
                 }
             }
-            manifold.touched = true;
-            manifold.staleFrames = 0;
-            contactTouchedBodies_[pair.i] = true;
-            contactTouchedBodies_[pair.j] = true;
+            markContactTouched_(manifold, pair.i, pair.j);
         }
     }
 
     void World::endContactFrame_()
     {
-        for (auto it = contactCache_.begin(); it != contactCache_.end();) {
-            ContactManifold& manifold = it->second;
+        // Single pass: age and evict stale manifolds, and clear the per-frame flags of the rest.
+        contactCache_.eraseIf([](const ContactKey&, ContactManifold& manifold) {
             if (manifold.touched) {
                 manifold.staleFrames = 0;
-                ++it;
-                continue;
-            }
-
-            ++manifold.staleFrames;
-            manifold.normalImpulse *= 0.75;
-            manifold.tangentImpulse *= 0.6;
-            if (manifold.staleFrames > 2 || manifold.normalImpulse < 1e-8) {
-                it = contactCache_.erase(it);
             } else {
-                ++it;
+                ++manifold.staleFrames;
+                manifold.normalImpulse *= Real(0.75);
+                manifold.tangentImpulse *= Real(0.6);
+                manifold.frictionImpulse *= Real(0.6);
+                if (manifold.staleFrames > 2 || manifold.normalImpulse < Real(1e-8)) {
+                    return true;
+                }
             }
-        }
+            manifold.touched = false;
+            manifold.appliedThisFrame = false;
+            return false;
+        });
     }
 
 } // namespace sim
@@ -0,0 +1,341 @@
+#include "World.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace sim {
+    namespace {
+        [[nodiscard]] bool isDynamicBody(const Body& b) {
+            return std::isfinite(b.invMass) && b.invMass > Real(0.0);
+        }
+
+        // Inert bodies never move on their own: sleeping dynamic bodies and static bodies at rest.
+        [[nodiscard]] bool isInertBody(const Body& b) {
+            if (isDynamicBody(b)) {
+                return b.sleeping;
+            }
+            return b.velocity.x == Real(0.0) && b.velocity.y == Real(0.0) && b.velocity.z == Real(0.0) &&
+                   b.angularVelocity.x == Real(0.0) && b.angularVelocity.y == Real(0.0) && b.angularVelocity.z == Real(0.0);
+        }
+
+        // Exact comparison on purpose: any edit, including one to NaN, counts as a change.
+        [[nodiscard]] bool sameBounds(const Body& b, const Vec3& position, const Real radius) {
+            return b.position.x == position.x && b.position.y == position.y && b.position.z == position.z &&
+                   b.radius == radius;
+        }
+    } // namespace
+
+    void World::refreshActivity_(const bool bodiesEdited)
+    {
+        if (bodiesEdited) {
+            syncBodySlots_();
+        }
+        resizeBodyState_();
+        const std::size_t count = bodies_.size();
+
+        // Callers may edit bodies between steps: honour sleep flags flipped by hand and wake
+        // sleeping bodies that were moved.
+        for (std::size_t i = 0; i < count; ++i) {
+            Body& body = bodies_[i];
+            const std::uint32_t island = sleepIslandOfBody_[i];
+            if (island != kNoSleepIsland) {
+                const InertSnapshot& snapshot = inertSnapshots_[i];
+                const bool moved = !inertSetDirty_ && !sameBounds(body, snapshot.position, snapshot.radius);
+                if (!body.sleeping || !isDynamicBody(body) || moved) {
+                    wakeSleepIsland_(island);
+                }
+            } else if (body.sleeping && isDynamicBody(body)) {
+                putIslandToSleep_(std::span<const std::size_t>(&i, 1));
+            }
+        }
+
+        awakeBodies_.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            Body& body = bodies_[i];
+            const bool inert = isInertBody(body);
+            if (!inert) {
+                awakeBodies_.push_back(i);
+            }
+            const InertSnapshot& snapshot = inertSnapshots_[i];
+            if (inert != snapshot.inert || (inert && !sameBounds(body, snapshot.position, snapshot.radius))) {
+                sanitizeBody_(body);
+                inertSetDirty_ = true;
+            }
+        }
+    }
+
+    void World::resizeBodyState_()
+    {
+        const std::size_t count = bodies_.size();
+        if (sleepIslandOfBody_.size() > count) {
+            // Bodies were removed behind the world's back; island membership is meaningless now.
+            wakeAllSleepIslands_();
+        }
+        if (sleepIslandOfBody_.size() != count) {
+            sleepIslandOfBody_.resize(count, kNoSleepIsland);
+            inertSnapshots_.resize(count);
+            inertSetDirty_ = true;
+        }
+        if (forces_.size() != count) {
+            forces_.resize(count);
+        }
+        if (contactTouchedBodies_.size() != count) {
+            contactTouchedBodies_.resize(count);
+        }
+    }
+
+    const broadphase::InertSet& World::inertBodies_()
+    {
+        if (!inertSetDirty_) {
+            return inertSet_;
+        }
+
+        auto& inert = scratch_->inertIndices;
+        inert.clear();
+        for (std::size_t i = 0; i < bodies_.size(); ++i) {
+            const Body& body = bodies_[i];
+            InertSnapshot& snapshot = inertSnapshots_[i];
+            snapshot.inert = isInertBody(body);
+            if (snapshot.inert) {
+                snapshot.position = body.position;
+                snapshot.radius = body.radius;
+                inert.push_back(i);
+            }
+        }
+        inertSet_.build(bodies_, inert, scratch_->broadphase);
+        inertSetDirty_ = false;
+        return inertSet_;
+    }
+
+    void World::wakeBody_(const std::size_t i)
+    {
+        // Awake bodies keep their sleep timers: those follow the velocity thresholds, so a
+        // resting contact that keeps applying small impulses can still fall asleep.
+        if (sleepIslandOfBody_[i] != kNoSleepIsland) {
+            wakeSleepIsland_(sleepIslandOfBody_[i]);
+        }
+    }
+
+    void World::wakeSleepIsland_(const std::uint32_t island)
+    {
+        SleepIsland& range = sleepIslands_[island];
+        for (std::size_t m = range.begin; m < range.end; ++m) {
+            const std::size_t i = sleepIslandMembers_[m];
+            Body& body = bodies_[i];
+            body.sleeping = false;
+            body.sleepTimer = 0.0;
+            sleepIslandOfBody_[i] = kNoSleepIsland;
+            forces_[i] = Vec3{};
+            contactTouchedBodies_[i] = false;
+            awakeBodies_.push_back(i);
+        }
+        sleepingBodyCount_ -= range.end - range.begin;
+        range.end = range.begin;
+        --sleepingIslandCount_;
+        inertSetDirty_ = true;
+        forcesStale_ = true;
+        compactSleepIslands_();
+    }
+
+    void World::wakeAllSleepIslands_()
+    {
+        for (std::size_t m = 0; m < sleepIslandMembers_.size(); ++m) {
+            const std::size_t i = sleepIslandMembers_[m];
+            if (i < bodies_.size() && i < sleepIslandOfBody_.size() && sleepIslandOfBody_[i] != kNoSleepIsland) {
+                bodies_[i].sleeping = false;
+                bodies_[i].sleepTimer = 0.0;
+            }
+        }
+        std::fill(sleepIslandOfBody_.begin(), sleepIslandOfBody_.end(), kNoSleepIsland);
+        std::fill(forces_.begin(), forces_.end(), Vec3{});
+        sleepIslandMembers_.clear();
+        sleepIslands_.clear();
+        sleepingIslandCount_ = 0;
+        sleepingBodyCount_ = 0;
+        inertSetDirty_ = true;
+        forcesStale_ = true;
+    }
+
+    void World::putIslandToSleep_(const std::span<const std::size_t> members)
+    {
+        const auto island = static_cast<std::uint32_t>(sleepIslands_.size());
+        const std::size_t begin = sleepIslandMembers_.size();
+        for (const std::size_t i : members) {
+            Body& body = bodies_[i];
+            body.sleeping = true;
+            body.velocity = Vec3{};
+            body.angularVelocity = Vec3{};
+            sleepIslandOfBody_[i] = island;
+            sleepIslandMembers_.push_back(i);
+        }
+        if (params_.deterministic) {
+            // A body woken and put back to sleep within one step is in neither awake list the
+            // state hash update reads.
+            scratch_->movedBodies.insert(scratch_->movedBodies.end(), members.begin(), members.end());
+        }
+        sleepIslands_.push_back(SleepIsland{begin, sleepIslandMembers_.size()});
+        ++sleepingIslandCount_;
+        sleepingBodyCount_ += members.size();
+        inertSetDirty_ = true;
+    }
+
+    void World::compactSleepIslands_()
+    {
+        // Woken islands leave empty ranges behind; squeeze them out once they dominate.
+        if (sleepingIslandCount_ == 0) {
+            sleepIslandMembers_.clear();
+            sleepIslands_.clear();
+            return;
+        }
+        if (sleepIslands_.size() < 2 * sleepingIslandCount_ + 16) {
+            return;
+        }
+
+        std::size_t members = 0;
+        std::size_t islands = 0;
+        for (const SleepIsland& range : sleepIslands_) {
+            if (range.begin == range.end) {
+                continue;
+            }
+            const std::size_t begin = members;
+            for (std::size_t m = range.begin; m < range.end; ++m) {
+                const std::size_t i = sleepIslandMembers_[m];
+                sleepIslandOfBody_[i] = static_cast<std::uint32_t>(islands);
+                sleepIslandMembers_[members++] = i;
+            }
+            sleepIslands_[islands++] = SleepIsland{begin, members};
+        }
+        sleepIslandMembers_.resize(members);
+        sleepIslands_.resize(islands);
+    }
+
+    void World::updateSleepState_(const Real dt)
+    {
+        linkSleepCandidates_(dt);
+        settleSleepIslands_();
+    }
+
+    void World::linkSleepCandidates_(const Real dt)
+    {
+        auto& candidates = scratch_->sleepCandidates;
+        candidates.clear();
+        if (!params_.enableSleeping) {
+            if (sleepingIslandCount_ > 0) {
+                wakeAllSleepIslands_();
+                refreshActivity_(false);
+            }
+            for (const std::size_t i : awakeBodies_) {
+                bodies_[i].sleeping = false;
+                bodies_[i].sleepTimer = 0.0;
+            }
+            return;
+        }
+
+        const Real linearThreshold = std::max<Real>(0.0, params_.sleepLinearThreshold);
+        const Real angularThreshold = std::max<Real>(0.0, params_.sleepAngularThreshold);
+        const Real linearThreshold2 = linearThreshold * linearThreshold;
+        const Real angularThreshold2 = angularThreshold * angularThreshold;
+
+        if (awakeSlotOfBody_.size() < bodies_.size()) {
+            awakeSlotOfBody_.resize(bodies_.size());
+        }
+        for (const std::size_t i : awakeBodies_) {
+            Body& body = bodies_[i];
+            if (!isDynamicBody(body)) {
+                continue;
+            }
+
+            const bool touching = i < contactTouchedBodies_.size() && contactTouchedBodies_[i];
+            const bool eligibleForSleep = !params_.enableGravity || touching;
+            const Real linearSpeed2 = body.velocity.dot(body.velocity);
+            const Real angularSpeed2 = body.angularVelocity.dot(body.angularVelocity);
+            const bool belowThresholds =
+                linearSpeed2 <= linearThreshold2 &&
+                angularSpeed2 <= angularThreshold2;
+
+            if (eligibleForSleep && belowThresholds) {
+                body.sleepTimer += dt;
+            } else {
+                body.sleepTimer = 0.0;
+            }
+            awakeSlotOfBody_[i] = static_cast<std::uint32_t>(candidates.size());
+            candidates.push_back(i);
+        }
+        if (candidates.empty()) {
+            return;
+        }
+
+        // Islands are the awake dynamic bodies linked by this frame's contacts; static bodies do
+        // not link. Any pair touching a sleeping body woke it before solving, so none remain here.
+        islandSets_.reset(candidates.size());
+        const auto isCandidate = [&](const std::size_t i) {
+            return i < bodies_.size() && !bodies_[i].sleeping && isDynamicBody(bodies_[i]) &&
+                   awakeSlotOfBody_[i] < candidates.size() && candidates[awakeSlotOfBody_[i]] == i;
+        };
+        for (std::size_t c = 0; c < contactCache_.size(); ++c) {
+            const ContactManifold& manifold = contactCache_.valueAt(c);
+            if (manifold.touched && isCandidate(manifold.bodyA) && isCandidate(manifold.bodyB)) {
+                islandSets_.unite(awakeSlotOfBody_[manifold.bodyA], awakeSlotOfBody_[manifold.bodyB]);
+            }
+        }
+    }
+
+    void World::settleSleepIslands_()
+    {
+        // Reads only what linkSleepCandidates_ left behind, not the contact cache.
+        const auto& candidates = scratch_->sleepCandidates;
+        if (!params_.enableSleeping || candidates.empty()) {
+            return;
+        }
+        const Real requiredSleepTime = std::max<Real>(0.0, params_.sleepTime);
+
+        // An island sleeps once its most recently active member has been still long enough.
+        auto& islandTimer = scratch_->islandTimers;
+        islandTimer.assign(candidates.size(), std::numeric_limits<Real>::infinity());
+        for (std::size_t c = 0; c < candidates.size(); ++c) {
+            Real& timer = islandTimer[islandSets_.find(c)];
+            timer = std::min(timer, bodies_[candidates[c]].sleepTimer);
+        }
+
+        bool anyReady = false;
+        for (std::size_t c = 0; c < candidates.size(); ++c) {
+            anyReady = anyReady || (islandSets_.find(c) == c && islandTimer[c] >= requiredSleepTime);
+        }
+        if (!anyReady) {
+            return;
+        }
+
+        // Group candidates by island (stable, so members keep index order) and put ready ones to
+        // sleep. Islands are keyed by their first candidate, not their union-find root: which
+        // member becomes the root depends on the order the contact cache was walked in.
+        auto& firstOfIsland = scratch_->islandLabels;
+        firstOfIsland.assign(candidates.size(), candidates.size());
+        auto& byIsland = scratch_->byIsland;
+        byIsland.clear();
+        for (std::size_t c = 0; c < candidates.size(); ++c) {
+            std::size_t& first = firstOfIsland[islandSets_.find(c)];
+            first = std::min(first, c);
+            byIsland.emplace_back(first, candidates[c]);
+        }
+        std::ranges::stable_sort(byIsland, {}, &std::pair<std::size_t, std::size_t>::first);
+
+        auto& members = scratch_->islandMembers;
+        bool anySlept = false;
+        for (std::size_t k = 0; k < byIsland.size();) {
+            const std::size_t first = byIsland[k].first;
+            members.clear();
+            for (; k < byIsland.size() && byIsland[k].first == first; ++k) {
+                members.push_back(byIsland[k].second);
+            }
+            if (islandTimer[islandSets_.find(first)] >= requiredSleepTime) {
+                putIslandToSleep_(members);
+                anySlept = true;
+            }
+        }
+        if (anySlept) {
+            std::erase_if(awakeBodies_, [&](const std::size_t i) { return bodies_[i].sleeping; });
+        }
+    }
+
+} // namespace sim
@@ -0,0 +1,237 @@
+#include "World.h"
+
+#include "Broadphase.h"
+#include "Collision.h"
+#include "ContactSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace sim {
+    namespace {
+        constexpr std::uint32_t kUnmapped = std::numeric_limits<std::uint32_t>::max();
+        // Soft contact tuning: stiff but heavily damped, never stiffer than a quarter of the
+        // substep rate, and never pushing out faster than kContactPushVelocity.
+        constexpr Real kContactHertz = 30.0;
+        constexpr Real kContactDampingRatio = 10.0;
+        constexpr Real kContactPushVelocity = 3.0;
+
+        [[nodiscard]] bool isDynamicBody(const Body& b) {
+            return std::isfinite(b.invMass) && b.invMass > Real(0.0);
+        }
+
+        // Conservative: could the gap between a and b close within dt at their current speeds?
+        [[nodiscard]] bool mayTouchWithin(const Body& a, const Body& b, const Real dt) {
+            const Vec3 d = b.position - a.position;
+            const Vec3 v = b.velocity - a.velocity;
+            const Real gap = d.magnitude() - (a.radius + b.radius);
+            return !(gap > v.magnitude() * std::abs(dt));
+        }
+    } // namespace
+
+    // Small-step (TGS) step: one broadphase and one contact preparation for the whole step, then
+    // `smallSteps` cheap substeps that integrate and relax the prepared rows. Every pair that may
+    // touch during the step gets a speculative row, and row gaps follow the bodies through
+    // deltaPosition, so no substep needs collision detection. Forces are evaluated once per step.
+    std::size_t World::stepSmall_(const Real dt)
+    {
+        beginContactFrame_();
+        const int substeps = std::clamp(params_.smallSteps, 1, Params::kMaxSmallSteps);
+        const Real h = dt / static_cast<Real>(substeps);
+
+        auto& contactPairs = scratch_->collidingPairs;
+        gatherSmallStepPairs_(dt, contactPairs);
+        const std::size_t awake = awakeBodies_.size();
+        prepareForces_();
+        computeForces_();
+
+        auto& activePairs = scratch_->activePairs;
+        activePairs.clear();
+        activePairs.reserve(contactPairs.size());
+        for (const auto& [i, j] : contactPairs) {
+            activePairs.push_back(ActiveCollisionPair{
+                .i = i,
+                .j = j,
+                .key = contactKeyForPair_(i, j),
+                .params = solveParamsForPair_(i, j),
+            });
+        }
+        const bool solveContacts = !activePairs.empty();
+        if (solveContacts) {
+            buildSolveSchedule_(contactPairs, activePairs);
+        }
+        prepareSmallStepConstraints_(activePairs, substeps);
+
+        const Real absH = std::abs(h);
+        const Real invH = absH > Real(0.0) ? Real(1.0) / absH : Real(0.0);
+        const collision::SoftContact soft = collision::softContact(
+            std::min<Real>(kContactHertz, Real(0.25) * invH), kContactDampingRatio, absH, kContactPushVelocity);
+        for (int substep = 0; substep < substeps; ++substep) {
+            integrateSmallStepVelocities_(h);
+            if (solveContacts) {
+                runSolveSchedule_(1, [this, invH, &soft](const std::size_t begin, const std::size_t end, bool) {
+                    collision::applyContactImpulses(contactConstraints_, solverBodies_, begin, end);
+                    collision::solveContactSubstep(contactConstraints_, solverBodies_, begin, end, invH, soft, true);
+                });
+            }
+            advanceSmallStepPositions_(h);
+            if (solveContacts) {
+                runSolveSchedule_(1, [this, invH, &soft](const std::size_t begin, const std::size_t end, bool) {
+                    collision::solveContactSubstep(contactConstraints_, solverBodies_, begin, end, invH, soft, false);
+                });
+            }
+        }
+        if (solveContacts) {
+            runSolveSchedule_(1, [this](const std::size_t begin, const std::size_t end, bool) {
+                collision::applyContactRestitution(contactConstraints_, solverBodies_, begin, end);
+            });
+        }
+
+        solverBodies_.scatter(bodies_);
+        solverBodies_.applyDisplacement(bodies_);
+        for (const std::size_t i : awakeBodies_) {
+            bodies_[i].torque = Vec3{};
+        }
+        storeSmallStepContacts_(activePairs, substeps);
+
+        sanitizeBodies_();
+        updateSleepState_(dt);
+        endContactFrame_();
+        return awake;
+    }
+
+    void World::gatherSmallStepPairs_(const Real dt, broadphase::PairList& outPairs)
+    {
+        outPairs.clear();
+        if (awakeBodies_.empty()) {
+            return;
+        }
+
+        // Waking an island adds movers whose pairs with each other the query skipped as inert, so
+        // query again until no pair wakes anything. Each round wakes at least one island.
+        auto& candidates = scratch_->sweptPairs;
+        bool woke = true;
+        while (woke) {
+            woke = false;
+            outPairs.clear();
+            broadphase::sweptPairs(bodies_, awakeBodies_, inertBodies_(), std::abs(dt), scratch_->broadphase, candidates);
+            for (const auto& [i, j] : candidates) {
+                const Body& A = bodies_[i];
+                const Body& B = bodies_[j];
+                if (!isDynamicBody(A) && !isDynamicBody(B)) {
+                    continue;
+                }
+                if (A.sleeping || B.sleeping) {
+                    if (!mayTouchWithin(A, B, dt)) {
+                        continue;
+                    }
+                    wakeBody_(i);
+                    wakeBody_(j);
+                    woke = true;
+                }
+                outPairs.emplace_back(i, j);
+            }
+        }
+    }
+
+    void World::prepareSmallStepConstraints_(const std::span<const ActiveCollisionPair> pairs, const int substeps)
+    {
+        solverBodies_.clear();
+        solverIndexOfBody_.assign(bodies_.size(), kUnmapped);
+        const auto solverIndex = [&](const std::size_t body) {
+            if (solverIndexOfBody_[body] == kUnmapped) {
+                solverIndexOfBody_[body] = solverBodies_.add(bodies_[body], body);
+            }
+            return solverIndexOfBody_[body];
+        };
+
+        contactConstraints_.resize(pairs.size());
+        for (std::size_t k = 0; k < pairs.size(); ++k) {
+            const ActiveCollisionPair& pair = pairs[k];
+            collision::prepareSpeculativeContact(
+                contactConstraints_,
+                k,
+                bodies_[pair.i],
+                bodies_[pair.j],
+                solverIndex(pair.i),
+                solverIndex(pair.j),
+                pair.params);
+
+            // The cache holds impulse per step; rows hold impulse per substep and are applied at
+            // the start of every substep, so they are only seeded here.
+            const ContactManifold* manifold = contactCache_.find(pair.key);
+            if (manifold != nullptr) {
+                const Real scale = Real(1.0) / static_cast<Real>(substeps);
+                collision::warmStartContact(
+                    contactConstraints_,
+                    solverBodies_,
+                    k,
+                    manifold->normalImpulse * scale,
+                    manifold->frictionImpulse * scale,
+                    false);
+            }
+        }
+    }
+
+    void World::integrateSmallStepVelocities_(const Real h)
+    {
+        for (const std::size_t i : awakeBodies_) {
+            const Body& b = bodies_[i];
+            if (!isDynamicBody(b)) {
+                continue;
+            }
+            const std::uint32_t s = solverIndexOfBody_[i];
+            Vec3& velocity = s != kUnmapped ? solverBodies_.velocity[s] : bodies_[i].velocity;
+            Vec3& angularVelocity = s != kUnmapped ? solverBodies_.angularVelocity[s] : bodies_[i].angularVelocity;
+            velocity += forces_[i] * (b.invMass * h);
+            const Real invI = collision::invInertiaSphere(b);
+            if (invI > Real(0.0)) {
+                angularVelocity += b.torque * (invI * h);
+            }
+        }
+    }
+
+    void World::advanceSmallStepPositions_(const Real h)
+    {
+        // Bodies with contact rows accumulate their displacement so the rows can track the gap;
+        // it is applied to the bodies once, after the last substep.
+        for (const std::size_t i : awakeBodies_) {
+            Body& b = bodies_[i];
+            const std::uint32_t s = solverIndexOfBody_[i];
+            if (s != kUnmapped) {
+                solverBodies_.deltaPosition[s] += solverBodies_.velocity[s] * h;
+                integrateOrientation(b.orientation, solverBodies_.angularVelocity[s], h);
+            } else {
+                b.position += b.velocity * h;
+                integrateOrientation(b.orientation, b.angularVelocity, h);
+            }
+        }
+    }
+
+    void World::storeSmallStepContacts_(const std::span<const ActiveCollisionPair> pairs, const int substeps)
+    {
+        const auto& rows = contactConstraints_;
+        for (std::size_t k = 0; k < pairs.size(); ++k) {
+            if (rows.active[k] == 0) {
+                continue;
+            }
+            const Vec3 n(rows.normalX[k], rows.normalY[k], rows.normalZ[k]);
+            const Vec3 moved = solverBodies_.deltaPosition[rows.bodyB[k]] - solverBodies_.deltaPosition[rows.bodyA[k]];
+            const Real gap = rows.separation[k] + moved.dot(n);
+            if (rows.normalImpulse[k] <= Real(0.0) && gap > Real(0.0)) {
+                continue;
+            }
+
+            const ActiveCollisionPair& pair = pairs[k];
+            ContactManifold& manifold = contactCache_[pair.key];
+            markContactTouched_(manifold, pair.i, pair.j);
+            const Real scale = static_cast<Real>(substeps);
+            manifold.normalImpulse = rows.normalImpulse[k] * scale;
+            manifold.frictionImpulse =
+                Vec3(rows.frictionImpulseX[k], rows.frictionImpulseY[k], rows.frictionImpulseZ[k]) * scale;
+            manifold.normal = n;
+        }
+    }
+
+} // namespace sim
@@ -460,6 +460,7 @@ void drawMenu(
 void drawHud(
     const Geometry& geometry,
     const double simSpeed,
+    const double achievedSimSpeed,
     const double simElapsed,
     const double fps,
     const OverlayRenderer::SpatialHud& spatialHud,
@@ -478,10 +479,10 @@ void drawHud(
     constexpr float hudY0 = 16.0f;
     constexpr float hudTextX = hudX0 + 10.0f;
     constexpr float hudTextY0 = hudY0 + 10.0f;
-    char speedLine[64];
+    char speedLine[96];
     char fpsLine[64];
     char timeLine[64];
-    formatHudSpeed(speedLine, sizeof(speedLine), simSpeed);
+    formatHudSpeed(speedLine, sizeof(speedLine), simSpeed, achievedSimSpeed);
     std::snprintf(fpsLine, sizeof(fpsLine), "FPS: %.1f", fps);
     formatElapsedTime(timeLine, sizeof(timeLine), simElapsed);
 
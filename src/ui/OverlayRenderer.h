@@ -62,6 +62,7 @@ public:
         int fbh,
         bool simFrozen,
         double simSpeed,
+        double achievedSimSpeed,
         double simElapsed,
         double fps,
         const ui::MenuView& menu,
@@ -143,6 +144,7 @@ public:
     struct HudSectionState {
         GeometryKey geometry{};
         double simSpeed = 1.0;
+        double achievedSimSpeed = 0.0;
         int elapsedSeconds = 0;
         double fps = 0.0;
         SpatialHud spatialHud{};
@@ -196,6 +198,7 @@ public:
         int fbh = 0;
         bool simFrozen = false;
         double simSpeed = 1.0;
+        double achievedSimSpeed = 0.0;
         double simElapsed = 0.0;
         double fps = 0.0;
         const ui::MenuView* menu = nullptr;
@@ -45,6 +45,7 @@ void OverlayRenderer::draw(
     int fbh,
     bool simFrozen,
     double simSpeed,
+    double achievedSimSpeed,
     double simElapsed,
     double fps,
     const ui::MenuView& menu,
@@ -65,6 +66,7 @@ void OverlayRenderer::draw(
         fbh,
         simFrozen,
         simSpeed,
+        achievedSimSpeed,
         simElapsed,
         fps,
         &menu,
@@ -144,6 +146,7 @@ void OverlayRenderer::updateCachedLayout(const FrameInput& input) const
             const HudSectionState nextHudState{
                 geometryKey,
                 input.showSimulationSpeed ? input.simSpeed : 0.0,
+                input.showSimulationSpeed ? input.achievedSimSpeed : 0.0,
                 input.showElapsedTime ? static_cast<int>(std::floor(std::max(0.0, input.simElapsed))) : 0,
                 input.showFps ? input.fps : 0.0,
                 cachedHudState,
@@ -160,6 +163,7 @@ void OverlayRenderer::updateCachedLayout(const FrameInput& input) const
                 overlay_renderer::drawHud(
                     geometry,
                     input.simSpeed,
+                    input.achievedSimSpeed,
                     input.simElapsed,
                     input.fps,
                     *input.spatialHud,
@@ -150,17 +150,29 @@ inline float fitScaleForWidth(const std::string& s, const float preferredScalePx
     if (unitWidth <= 0.0f || maxWidthPx <= 0.0f) return preferredScalePx;
     return std::min(preferredScalePx, maxWidthPx / unitWidth);
 }
-inline void formatHudSpeed(char* out, const std::size_t outSize, const double simSpeed) {
-    const double absSpeed = std::abs(simSpeed);
+inline void formatSpeedValue(char* out, const std::size_t outSize, const double speed) {
+    const double absSpeed = std::abs(speed);
     if (absSpeed < 0.01) {
-        std::snprintf(out, outSize, "SPEED: %.4fX", simSpeed);
+        std::snprintf(out, outSize, "%.4fX", speed);
         return;
     }
     if (absSpeed < 0.1) {
-        std::snprintf(out, outSize, "SPEED: %.3fX", simSpeed);
+        std::snprintf(out, outSize, "%.3fX", speed);
         return;
     }
-    std::snprintf(out, outSize, "SPEED: %.2fX", simSpeed);
+    std::snprintf(out, outSize, "%.2fX", speed);
+}
+// The achieved speed is only shown once the simulation visibly falls behind the requested one.
+inline void formatHudSpeed(char* out, const std::size_t outSize, const double simSpeed, const double achievedSpeed) {
+    char requested[32];
+    formatSpeedValue(requested, sizeof(requested), simSpeed);
+    if (achievedSpeed > 0.0 && achievedSpeed < 0.95 * simSpeed) {
+        char achieved[32];
+        formatSpeedValue(achieved, sizeof(achieved), achievedSpeed);
+        std::snprintf(out, outSize, "SPEED: %s  ACTUAL %s", requested, achieved);
+        return;
+    }
+    std::snprintf(out, outSize, "SPEED: %s", requested);
 }
 
 inline void formatElapsedTime(char* out, const std::size_t outSize, const double elapsedSeconds) {
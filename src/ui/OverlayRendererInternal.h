@@ -118,6 +118,7 @@ void drawMenu(const ui::MenuView& menu, const Geometry& geometry, const Buffers&
 void drawHud(
     const Geometry& geometry,
     double simSpeed,
+    double achievedSimSpeed,
     double simElapsed,
     double fps,
     const OverlayRenderer::SpatialHud& spatialHud,
@@ -136,7 +136,7 @@ public:
 
     void loadSettings(const std::string& path);
     void applyCurrentDisplaySettings(GLFWwindow* window);
-    void updateEscapeState(GLFWwindow* window, bool& mouseCaptured, bool& firstMouse, double& lastFrameTime, double& accumulator, double& alpha, std::vector<sim::Body>& bodies);
+    void updateEscapeState(GLFWwindow* window, bool& mouseCaptured, bool& firstMouse, double& lastFrameTime, double& accumulator, double& alpha);
     void handlePressedKey(GLFWwindow* window, int pressedKey, input::ControlBindings& controls, const std::string& controlsConfigPath);
     void handlePointerInput(GLFWwindow* window, input::ControlBindings& controls, const std::string& controlsConfigPath, float scrollDeltaY = 0.0f);
     void updateContinuousInput(GLFWwindow* window, const input::ControlBindings& controls);
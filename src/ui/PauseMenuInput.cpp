@@ -10,8 +10,7 @@ void PauseMenu::updateEscapeState(
     bool& firstMouse,
     double& lastFrameTime,
     double& accumulator,
-    double& alpha,
-    std::vector<sim::Body>& bodies)
+    double& alpha)
 {
     if (window == nullptr) {
         return;
@@ -61,10 +60,6 @@ void PauseMenu::updateEscapeState(
             lastFrameTime = glfwGetTime();
             accumulator = 0.0;
             alpha = 0.0;
-            for (auto& body : bodies) {
-                body.prevPosition = body.position;
-                body.prevOrientation = body.orientation;
-            }
         }
     }
 
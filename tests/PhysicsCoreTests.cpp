@@ -1,18 +1,40 @@
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <limits>
+#include <memory_resource>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 #include "TestRegistry.h"
 
 #include "sim/Broadphase.h"
 #include "sim/Collision.h"
+#include "sim/ContactIslands.h"
+#include "sim/ContactSolver.h"
+#include "sim/DefaultWorld.h"
+#include "sim/Ensemble.h"
+#include "sim/FlatPairMap.h"
+#include "sim/FrameArena.h"
+#include "sim/JobSystem.h"
 #include "sim/Material.h"
+#include "sim/Parareal.h"
+#include "sim/SessionScheduler.h"
+#include "sim/TripleBuffer.h"
 #include "sim/World.h"
 
 namespace {
 using sim::Body;
 using sim::Vec3;
 
+// Bounds for results that should agree up to rounding; single-precision builds round much earlier.
+constexpr bool kSinglePrecision = std::is_same_v<sim::Real, float>;
+constexpr double kRoundingTolerance = kSinglePrecision ? 1e-5 : 1e-12;
+constexpr double kDriftTolerance = kSinglePrecision ? 1e-4 : 1e-9;
+
 [[nodiscard]] Body makeDynamicBody(const Vec3& position, const double radius, const double mass)
 {
     Body body{};
@@ -150,7 +172,7 @@ void testBoundarySanitizationRepairsInvalidBodies()
     constructedBadBody.position.x = std::nan("");
     constructedBadBody.velocity.z = std::numeric_limits<double>::infinity();
     constructedBadBody.radius = -2.0;
-    constructedBadBody.materialName.clear();
+    constructedBadBody.material = sim::kInvalidMaterial;
 
     sim::World constructedWorld(std::vector<Body>{constructedBadBody}, params);
     const Body& constructedRepaired = constructedWorld.bodies().front();
@@ -158,15 +180,15 @@ void testBoundarySanitizationRepairsInvalidBodies()
         "world construction should sanitize invalid numeric state");
     require(constructedRepaired.radius > 0.0,
         "world construction should sanitize invalid body radius");
-    require(!constructedRepaired.materialName.empty(),
-        "world construction should repair missing material names");
+    require(sim::isValidMaterial(constructedRepaired.material),
+        "world construction should repair invalid material handles");
 
     sim::World addBodyWorld(params);
     Body addedBadBody = makeDynamicBody(Vec3(0.0, 0.0, 0.0), 1.0, 1.0);
     addedBadBody.angularVelocity.x = std::nan("");
     addedBadBody.sleepTimer = -1.0;
     addedBadBody.radius = 0.0;
-    addedBadBody.materialName.clear();
+    addedBadBody.material = sim::kInvalidMaterial;
     addBodyWorld.addBody(addedBadBody);
 
     const Body& addedRepaired = addBodyWorld.bodies().front();
@@ -176,8 +198,1427 @@ void testBoundarySanitizationRepairsInvalidBodies()
         "addBody should sanitize invalid sleep timer");
     require(addedRepaired.radius > 0.0,
         "addBody should sanitize invalid radius");
-    require(!addedRepaired.materialName.empty(),
-        "addBody should repair missing material names");
+    require(sim::isValidMaterial(addedRepaired.material),
+        "addBody should repair invalid material handles");
+}
+
+[[nodiscard]] std::vector<Body> makeSeparatedClusters(const int clusterCount)
+{
+    std::vector<Body> bodies;
+    for (int c = 0; c < clusterCount; ++c) {
+        const Vec3 origin(30.0 * static_cast<double>(c), 0.0, 0.0);
+        bodies.push_back(makeStaticBody(origin + Vec3(1.0, -2.4, 0.5), 1.0));
+        for (int x = 0; x < 3; ++x) {
+            for (int y = 0; y < 3; ++y) {
+                for (int z = 0; z < 2; ++z) {
+                    Body body = makeDynamicBody(
+                        origin + Vec3(0.95 * x, 0.95 * y, 0.95 * z), 0.5, 1.0 + 0.1 * (x + y + z));
+                    body.velocity = Vec3(0.3 * (1 - x), -0.5, 0.2 * (z == 0 ? 1.0 : -1.0));
+                    bodies.push_back(body);
+                }
+            }
+        }
+    }
+    return bodies;
+}
+
+void testContactIslandPartition()
+{
+    std::vector<Body> bodies;
+    bodies.push_back(makeStaticBody(Vec3(0.0, 0.0, 0.0), 1.0));
+    bodies.push_back(makeDynamicBody(Vec3(1.5, 0.0, 0.0), 1.0, 1.0));
+    bodies.push_back(makeDynamicBody(Vec3(3.0, 0.0, 0.0), 1.0, 1.0));
+    bodies.push_back(makeDynamicBody(Vec3(-1.5, 0.0, 0.0), 1.0, 1.0));
+    bodies.push_back(makeDynamicBody(Vec3(-3.0, 0.0, 0.0), 1.0, 1.0));
+
+    const std::vector<sim::islands::PairIndex> pairs{{0, 1}, {0, 3}, {1, 2}, {3, 4}};
+    sim::islands::DisjointSet sets;
+    sim::islands::PartitionScratch scratch;
+    sim::islands::IslandPartition partition;
+    sim::islands::buildPairIslands(bodies, pairs, sets, scratch, partition);
+
+    require(partition.islandCount() == 2, "a shared static body must not merge islands");
+    require(partition.pairOrder == std::vector<std::size_t>{0, 2, 1, 3},
+        "islands should be ordered by first pair and keep input order internally");
+    require(partition.islandOffsets == std::vector<std::size_t>{0, 2, 4},
+        "island offsets should delimit contiguous pair ranges");
+}
+
+void testParallelIslandSolveMatchesSerial()
+{
+    sim::World::Params params{};
+    params.enableGravity = false;
+    params.enableSleeping = false;
+    params.velocityIterations = 4;
+    params.positionIterations = 2;
+
+    sim::World serialWorld(makeSeparatedClusters(8), params);
+    params.workerThreads = 4;
+    sim::World parallelWorld(makeSeparatedClusters(8), params);
+
+    for (int step = 0; step < 10; ++step) {
+        serialWorld.step(1.0 / 60.0);
+        parallelWorld.step(1.0 / 60.0);
+    }
+
+    const auto& serial = serialWorld.bodies();
+    const auto& parallel = parallelWorld.bodies();
+    for (std::size_t i = 0; i < serial.size(); ++i) {
+        require(serial[i].position.x == parallel[i].position.x &&
+                serial[i].position.y == parallel[i].position.y &&
+                serial[i].position.z == parallel[i].position.z &&
+                serial[i].velocity.x == parallel[i].velocity.x &&
+                serial[i].velocity.y == parallel[i].velocity.y &&
+                serial[i].velocity.z == parallel[i].velocity.z,
+            "island-parallel contact solving should reproduce the serial result exactly");
+    }
+}
+
+[[nodiscard]] std::vector<Body> makeSinglePile(const int side)
+{
+    std::vector<Body> bodies;
+    bodies.push_back(makeStaticBody(Vec3(0.0, -5.0, 0.0), 4.6));
+    for (int x = 0; x < side; ++x) {
+        for (int y = 0; y < side; ++y) {
+            for (int z = 0; z < side; ++z) {
+                Body body = makeDynamicBody(
+                    Vec3(0.95 * (x - side / 2), 0.95 * y, 0.95 * (z - side / 2)), 0.5, 1.0 + 0.05 * y);
+                body.velocity = Vec3(0.0, -1.0, 0.0);
+                bodies.push_back(body);
+            }
+        }
+    }
+    return bodies;
+}
+
+void testContactPairColoring()
+{
+    std::vector<Body> bodies;
+    bodies.push_back(makeStaticBody(Vec3(0.0, -1.0, 0.0), 1.0));
+    for (int i = 0; i < 4; ++i) {
+        bodies.push_back(makeDynamicBody(Vec3(1.5 * i, 0.0, 0.0), 1.0, 1.0));
+    }
+
+    const std::vector<sim::islands::PairIndex> pairs{{0, 1}, {0, 2}, {0, 3}, {1, 2}, {2, 3}, {3, 4}};
+    sim::islands::PartitionScratch scratch;
+    sim::islands::ColorPartition colors;
+    sim::islands::buildPairColors(bodies, pairs, scratch, colors);
+
+    require(!colors.overflowColor, "a short chain should not overflow the color budget");
+    require(colors.colorOffsets == std::vector<std::size_t>{0, 3, 5, 6},
+        "static bodies should be shareable inside one color");
+    for (std::size_t c = 0; c < colors.colorCount(); ++c) {
+        std::vector<std::size_t> seen;
+        for (std::size_t k = colors.colorOffsets[c]; k < colors.colorOffsets[c + 1]; ++k) {
+            const auto& [i, j] = pairs[colors.pairOrder[k]];
+            for (const std::size_t body : {i, j}) {
+                if (body == 0) {
+                    continue;
+                }
+                require(std::ranges::find(seen, body) == seen.end(),
+                    "a dynamic body must appear at most once per color");
+                seen.push_back(body);
+            }
+        }
+    }
+}
+
+void testColoredSolveIsThreadCountIndependent()
+{
+    sim::World::Params params{};
+    params.enableGravity = false;
+    params.enableSleeping = false;
+    params.workerThreads = 2;
+
+    sim::World twoThreads(makeSinglePile(7), params);
+    params.workerThreads = 4;
+    sim::World fourThreads(makeSinglePile(7), params);
+
+    for (int step = 0; step < 5; ++step) {
+        twoThreads.step(1.0 / 60.0);
+        fourThreads.step(1.0 / 60.0);
+    }
+
+    const auto& a = twoThreads.bodies();
+    const auto& b = fourThreads.bodies();
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        require(std::isfinite(a[i].position.y) && std::isfinite(a[i].velocity.y),
+            "colored solve should keep a single large pile finite");
+        require(a[i].position.x == b[i].position.x &&
+                a[i].position.y == b[i].position.y &&
+                a[i].position.z == b[i].position.z &&
+                a[i].velocity.y == b[i].velocity.y,
+            "color batches should give the same result for any worker count");
+    }
+}
+
+void testPreparedContactMatchesPairSolver()
+{
+    Body a = makeDynamicBody(Vec3(0.0, 0.0, 0.0), 1.0, 2.0);
+    Body b = makeDynamicBody(Vec3(1.8, 0.3, 0.0), 1.0, 1.0);
+    a.velocity = Vec3(2.0, 0.5, 0.0);
+    b.velocity = Vec3(-1.0, 0.0, 0.3);
+    a.angularVelocity = Vec3(0.0, 0.0, 1.0);
+
+    sim::collision::SolveParams params{};
+    params.applyPositionCorrection = false;
+    Body pairA = a;
+    Body pairB = b;
+    sim::collision::solveCollisionPair(pairA, pairB, params, false);
+
+    sim::collision::SolverBodies solverBodies;
+    sim::collision::ContactConstraints constraints;
+    constraints.resize(1);
+    const auto solverA = solverBodies.add(a, 0);
+    const auto solverB = solverBodies.add(b, 1);
+    sim::collision::prepareContact(constraints, 0, a, b, solverA, solverB, params);
+    sim::collision::solveContactVelocities(constraints, solverBodies, 0, 1);
+    std::vector<Body> bodies{a, b};
+    solverBodies.scatter(bodies);
+
+    const auto near = [](const Vec3& lhs, const Vec3& rhs) {
+        return (lhs - rhs).magnitude() < kRoundingTolerance;
+    };
+    require(constraints.active[0] == 1 && constraints.impulseApplied[0] == 1,
+        "an approaching overlapping pair should produce an active, applied constraint row");
+    require(near(bodies[0].velocity, pairA.velocity) && near(bodies[1].velocity, pairB.velocity) &&
+            near(bodies[0].angularVelocity, pairA.angularVelocity) &&
+            near(bodies[1].angularVelocity, pairB.angularVelocity),
+        "prepared constraint rows should reproduce the per-pair velocity solve");
+}
+
+void testWideContactSolverMatchesScalar()
+{
+    std::vector<Body> bodies;
+    bodies.push_back(makeStaticBody(Vec3(0.0, -10.0, 0.0), 8.0));
+    sim::collision::SolverBodies scalarBodies;
+    sim::collision::ContactConstraints scalarRows;
+    constexpr int kRows = 19;
+    scalarRows.resize(kRows);
+    const auto ground = scalarBodies.add(bodies[0], 0);
+    for (int r = 0; r < kRows; ++r) {
+        Body a = makeDynamicBody(Vec3(3.0 * r, 0.0, 0.0), 1.0, 1.0 + 0.1 * r);
+        a.velocity = Vec3(0.4 * r, -2.0, 0.1);
+        a.angularVelocity = Vec3(0.0, 0.3, -0.2 * r);
+        if (r % 3 == 0) {
+            a.position = Vec3(0.3 * r, -1.1, 0.0);
+            bodies.push_back(a);
+            const auto solverA = scalarBodies.add(a, bodies.size() - 1);
+            sim::collision::prepareContact(scalarRows, r, bodies[0], a, ground, solverA, {});
+            continue;
+        }
+        Body b = makeDynamicBody(a.position + Vec3(0.2, -1.9, 0.1), 1.0, 2.0);
+        b.velocity = Vec3(-0.5, 1.0, 0.05 * r);
+        bodies.push_back(a);
+        const auto solverA = scalarBodies.add(a, bodies.size() - 1);
+        bodies.push_back(b);
+        const auto solverB = scalarBodies.add(b, bodies.size() - 1);
+        sim::collision::prepareContact(scalarRows, r, a, b, solverA, solverB, {});
+    }
+
+    using sim::collision::ImpulseMode;
+    for (const ImpulseMode mode : {ImpulseMode::PerIteration, ImpulseMode::Accumulated}) {
+        sim::collision::SolverBodies modeBodies = scalarBodies;
+        sim::collision::ContactConstraints modeRows = scalarRows;
+        sim::collision::solveContactVelocities(modeRows, modeBodies, 0, kRows, mode);
+        for (const std::size_t lanes : {std::size_t{4}, std::size_t{8}}) {
+            sim::collision::SolverBodies wideBodies = scalarBodies;
+            sim::collision::ContactConstraints wideRows = scalarRows;
+            sim::collision::solveContactVelocitiesWide(wideRows, wideBodies, 0, kRows, lanes, mode);
+
+            require(wideRows.normalImpulse == modeRows.normalImpulse &&
+                    wideRows.frictionImpulseX == modeRows.frictionImpulseX &&
+                    wideRows.frictionImpulseZ == modeRows.frictionImpulseZ &&
+                    wideRows.impulseApplied == modeRows.impulseApplied,
+                "lane solver should accumulate the same impulses as the scalar sweep");
+            for (std::size_t b = 0; b < bodies.size(); ++b) {
+                require(wideBodies.velocity[b].x == modeBodies.velocity[b].x &&
+                        wideBodies.velocity[b].y == modeBodies.velocity[b].y &&
+                        wideBodies.velocity[b].z == modeBodies.velocity[b].z &&
+                        wideBodies.angularVelocity[b].x == modeBodies.angularVelocity[b].x &&
+                        wideBodies.angularVelocity[b].y == modeBodies.angularVelocity[b].y &&
+                        wideBodies.angularVelocity[b].z == modeBodies.angularVelocity[b].z,
+                    "lane solver should reproduce scalar velocities exactly");
+            }
+        }
+    }
+}
+
+void testAccumulatedImpulsesStayInsideCone()
+{
+    Body ground = makeStaticBody(Vec3(0.0, -1.0, 0.0), 1.0);
+    Body ball = makeDynamicBody(Vec3(0.0, 0.95, 0.0), 1.0, 1.0);
+    ball.velocity = Vec3(3.0, -0.5, 1.0);
+
+    sim::collision::SolveParams params{};
+    params.staticFriction = 0.4;
+    params.dynamicFriction = 0.3;
+    sim::collision::SolverBodies solverBodies;
+    sim::collision::ContactConstraints rows;
+    rows.resize(1);
+    const auto solverGround = solverBodies.add(ground, 0);
+    const auto solverBall = solverBodies.add(ball, 1);
+    sim::collision::prepareContact(rows, 0, ground, ball, solverGround, solverBall, params);
+
+    // A stale warm start pushing far too hard must be taken back by the clamped total.
+    sim::collision::warmStartContact(rows, solverBodies, 0, 5.0, Vec3(-2.0, 0.0, 0.0), true);
+    sim::collision::updateVelocityBias(rows, solverBodies, 0);
+    for (int it = 0; it < 8; ++it) {
+        sim::collision::solveAccumulatedContactVelocities(rows, solverBodies, 0, 1);
+        const double friction = std::sqrt(
+            rows.frictionImpulseX[0] * rows.frictionImpulseX[0] +
+            rows.frictionImpulseY[0] * rows.frictionImpulseY[0] +
+            rows.frictionImpulseZ[0] * rows.frictionImpulseZ[0]);
+        require(rows.normalImpulse[0] >= 0.0, "accumulated normal impulse must never pull");
+        require(friction <= rows.normalImpulse[0] * params.staticFriction + kRoundingTolerance,
+            "accumulated friction must stay inside the Coulomb cone");
+    }
+    require(std::abs(solverBodies.velocity[solverBall].y) < kRoundingTolerance,
+        "accumulated normal row should remove the over-applied warm start");
+}
+
+void testAccumulatedImpulsesSettleStack()
+{
+    sim::World::Params params{};
+    params.G = 0.025;
+    params.enableSleeping = false;
+    params.velocityIterations = 2;
+    params.accumulateContactImpulses = true;
+
+    // A heavy dynamic planet gives roughly 10 m/s^2 at its surface; static bodies do not attract.
+    std::vector<Body> bodies;
+    bodies.push_back(makeDynamicBody(Vec3(0.0, -50.0, 0.0), 50.0, 1e6));
+    for (int y = 0; y < 8; ++y) {
+        bodies.push_back(makeDynamicBody(Vec3(0.0, 0.5 + y, 0.0), 0.5, 1.0));
+    }
+    sim::World world(std::move(bodies), params);
+    for (int step = 0; step < 120; ++step) {
+        world.step(1.0 / 60.0);
+    }
+
+    std::vector<Vec3> settled;
+    for (const Body& body : world.bodies()) {
+        settled.push_back(body.position - world.bodies().front().position);
+    }
+    for (int step = 0; step < 60; ++step) {
+        world.step(1.0 / 60.0);
+    }
+    for (std::size_t i = 1; i < settled.size(); ++i) {
+        const Vec3 drift = world.bodies()[i].position - world.bodies().front().position - settled[i];
+        require(drift.magnitude() < kDriftTolerance,
+            "a stack solved with accumulated impulses should rest with two velocity iterations");
+    }
+}
+
+void testSplitImpulseSeparatesWithoutVelocity()
+{
+    sim::World::Params params{};
+    params.enableGravity = false;
+    params.enableSleeping = false;
+    params.splitImpulse = true;
+
+    std::vector<Body> bodies;
+    bodies.push_back(makeDynamicBody(Vec3(0.0, 0.0, 0.0), 0.5, 1.0));
+    bodies.push_back(makeDynamicBody(Vec3(0.8, 0.0, 0.0), 0.5, 3.0));
+    sim::World world(std::move(bodies), params);
+    world.step(1.0 / 60.0);
+
+    const auto& pair = world.bodies();
+    const double depth = 1.0 - (pair[1].position - pair[0].position).magnitude();
+    require(depth < 0.01, "split impulse should push the overlap out within one step");
+    require(pair[0].velocity.magnitude() == 0.0 && pair[1].velocity.magnitude() == 0.0,
+        "split-impulse correction should leave velocities untouched");
+    const double centerOfMass = pair[0].position.x * 1.0 + pair[1].position.x * 3.0;
+    require(std::abs(centerOfMass - 2.4) < kDriftTolerance, "correction should be split by inverse mass");
+}
+
+void testGravityMatchesPairwiseSum()
+{
+    sim::World::Params params{};
+    params.G = 2.0;
+    params.enableCollisions = false;
+
+    std::vector<Body> bodies;
+    bodies.push_back(makeDynamicBody(Vec3(0.0, 0.0, 0.0), 0.5, 3.0));
+    bodies.push_back(makeDynamicBody(Vec3(4.0, 1.0, 0.0), 0.5, 5.0));
+    bodies.push_back(makeDynamicBody(Vec3(-2.0, 3.0, 1.0), 0.5, 7.0));
+    bodies.push_back(makeDynamicBody(Vec3(1.0, -5.0, 2.0), 0.5, 11.0));
+    bodies.push_back(makeStaticBody(Vec3(0.0, 9.0, 0.0), 0.5));
+    const std::vector<Body> initial = bodies;
+    sim::World world(std::move(bodies), params);
+    world.bodies()[3].sleeping = true;
+
+    constexpr double dt = 1e-6;
+    world.step(dt);
+
+    // Awake bodies feel every dynamic body, the sleeping one included; static bodies do not attract.
+    for (std::size_t i = 0; i < 3; ++i) {
+        Vec3 expected{};
+        for (std::size_t j = 0; j < 4; ++j) {
+            if (i == j) {
+                continue;
+            }
+            const Vec3 d = initial[j].position - initial[i].position;
+            const double r = d.magnitude();
+            expected += d * (params.G / initial[j].invMass / (r * r * r));
+        }
+        const Vec3 acceleration = world.bodies()[i].velocity / dt;
+        require((acceleration - expected).magnitude() < 1e-6 * expected.magnitude(),
+            "gravity should match the direct pairwise sum");
+    }
+    require(world.bodies()[3].velocity.magnitude() == 0.0, "sleeping bodies attract but do not move");
+}
+
+void testMaterialHandlesDriveContactParameters()
+{
+    const sim::MaterialHandle bouncy = sim::registerMaterial(sim::Material{
+        .name = "TEST_BOUNCY",
+        .restitution = 1.0,
+        .staticFriction = 0.0,
+        .dynamicFriction = 0.0,
+    });
+    require(bouncy != sim::kDefaultMaterial && sim::isValidMaterial(bouncy), "registration should hand out a new handle");
+    require(sim::registerMaterial(sim::Material{
+                .name = "TEST_BOUNCY",
+                .restitution = 1.0,
+                .staticFriction = 0.0,
+                .dynamicFriction = 0.0,
+            }) == bouncy,
+        "registering the same definition again should return its existing handle");
+    Body redefined = makeDynamicBody(Vec3(0.0, 0.0, 0.0), 1.0, 1.0);
+    require(sim::applyMaterial(redefined, sim::Material{.name = "DEFAULT", .restitution = 0.9}) == sim::kInvalidMaterial &&
+                redefined.material == sim::kDefaultMaterial,
+        "redefining a registered name should fail and leave the body alone");
+    require(sim::findMaterial("TEST_BOUNCY") == bouncy && sim::materialName(bouncy) == "TEST_BOUNCY",
+        "handles and names should round-trip");
+    require(sim::findMaterial("NO_SUCH_MATERIAL") == sim::kInvalidMaterial, "unknown names should not resolve");
+
+    sim::World::Params params{};
+    params.enableGravity = false;
+    params.restitution = 1.0;
+    std::vector<Body> bodies;
+    bodies.push_back(makeDynamicBody(Vec3(-1.0, 0.0, 0.0), 0.5, 1.0));
+    bodies.push_back(makeDynamicBody(Vec3(1.0, 0.0, 0.0), 0.5, 1.0));
+    bodies[0].velocity = Vec3(2.0, 0.0, 0.0);
+    bodies[1].velocity = Vec3(-2.0, 0.0, 0.0);
+    sim::assignMaterial(bodies[0], "TEST_BOUNCY");
+    sim::assignMaterial(bodies[1], "TEST_BOUNCY");
+    sim::World world(std::move(bodies), params);
+    for (int step = 0; step < 30; ++step) {
+        world.step(1.0 / 60.0);
+    }
+    require(std::abs(world.bodies()[0].velocity.x + 2.0) < 1e-6 && std::abs(world.bodies()[1].velocity.x - 2.0) < 1e-6,
+        "a fully elastic material pair should swap the velocities of equal masses");
+}
+
+void testSmallStepSolverRestsTallStack()
+{
+    sim::World::Params params{};
+    params.G = 0.025;
+    params.enableSleeping = false;
+    params.smallStepSolver = true;
+    params.smallSteps = 4;
+
+    std::vector<Body> bodies;
+    bodies.push_back(makeDynamicBody(Vec3(0.0, -50.0, 0.0), 50.0, 1e6));
+    for (int y = 0; y < 16; ++y) {
+        bodies.push_back(makeDynamicBody(Vec3(0.0, 0.5 + y, 0.0), 0.5, 1.0));
+    }
+    sim::World world(std::move(bodies), params);
+    for (int step = 0; step < 120; ++step) {
+        world.step(1.0 / 60.0);
+    }
+
+    std::vector<Vec3> settled;
+    for (const Body& body : world.bodies()) {
+        settled.push_back(body.position - world.bodies().front().position);
+    }
+    for (int step = 0; step < 60; ++step) {
+        world.step(1.0 / 60.0);
+    }
+    const auto& stack = world.bodies();
+    for (std::size_t i = 1; i < stack.size(); ++i) {
+        const Vec3 drift = stack[i].position - stack.front().position - settled[i];
+        require(drift.magnitude() < 1e-3, "a small-step stack should stay at rest");
+        const double gap = (stack[i].position - stack[i - 1].position).magnitude() - stack[i].radius - stack[i - 1].radius;
+        require(gap > -0.02, "small-step contacts should hold penetration to a few centimetres");
+    }
+}
+
+void testSmallStepSolverStopsFastBody()
+{
+    sim::World::Params params{};
+    params.enableGravity = false;
+    params.smallStepSolver = true;
+
+    std::vector<Body> bodies;
+    Body mover = makeDynamicBody(Vec3(-5.0, 0.0, 0.0), 0.5, 1.0);
+    mover.velocity = Vec3(40.0, 0.0, 0.0);
+    bodies.push_back(mover);
+    bodies.push_back(makeStaticBody(Vec3(0.0, 0.0, 0.0), 0.5));
+
+    sim::World world(std::move(bodies), params);
+    world.step(0.2);
+
+    // One broadphase for the whole step: the speculative row has to catch the hit on its own.
+    const Body& stepped = world.bodies()[0];
+    require(stepped.position.x < -0.9, "a speculative contact should stop the body before it tunnels");
+    require(stepped.velocity.x < 0.0, "the body should bounce off the target");
+}
+
+void testWideLaneWidthsAgreeInWorld()
+{
+    sim::World::Params params{};
+    params.enableGravity = false;
+    params.enableSleeping = false;
+    params.contactSolverLanes = 4;
+    sim::World fourLanes(makeSinglePile(5), params);
+    params.contactSolverLanes = 8;
+    params.workerThreads = 3;
+    sim::World eightLanes(makeSinglePile(5), params);
+
+    for (int step = 0; step < 5; ++step) {
+        fourLanes.step(1.0 / 60.0);
+        eightLanes.step(1.0 / 60.0);
+    }
+
+    const auto& a = fourLanes.bodies();
+    const auto& b = eightLanes.bodies();
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        require(std::isfinite(a[i].velocity.x) && std::isfinite(a[i].velocity.y),
+            "lane solver should keep the pile finite");
+        require(a[i].position.y == b[i].position.y && a[i].velocity.y == b[i].velocity.y &&
+                a[i].angularVelocity.x == b[i].angularVelocity.x,
+            "4- and 8-wide lane batches should give identical results");
+    }
+}
+
+void testFlatPairMapInsertFindErase()
+{
+    sim::FlatPairMap<int> map;
+    for (std::uint64_t a = 0; a < 40; ++a) {
+        for (std::uint64_t b = a + 1; b < 40; b += 3) {
+            map[{a, b}] = static_cast<int>(a * 100 + b);
+        }
+    }
+    const std::size_t inserted = map.size();
+    require(map.find({3, 4}) != nullptr && *map.find({3, 4}) == 304, "inserted keys should be found");
+    require(map.find({4, 3}) == nullptr, "keys are ordered pairs");
+
+    // Erase every other entry, then make sure every survivor is still reachable through its probe chain.
+    map.eraseIf([](const auto& key, const int) { return (key.first + key.second) % 2 == 0; });
+    require(map.size() < inserted, "eraseIf should remove matching entries");
+    for (std::uint64_t a = 0; a < 40; ++a) {
+        for (std::uint64_t b = a + 1; b < 40; b += 3) {
+            const int* value = map.find({a, b});
+            if ((a + b) % 2 == 0) {
+                require(value == nullptr, "erased keys should be gone");
+            } else {
+                require(value != nullptr && *value == static_cast<int>(a * 100 + b),
+                    "surviving keys should keep their values after backward-shift deletion");
+            }
+        }
+    }
+    for (std::size_t index = 0; index < map.size(); ++index) {
+        require(map.find(map.keyAt(index)) == &map.valueAt(index), "dense entries and slots should agree");
+    }
+
+    map[{100, 200}] = 7;
+    require(map[{100, 200}] == 7 && map.find({100, 200}) != nullptr, "operator[] should reuse an existing entry");
+}
+
+void testInertBroadphaseMatchesFullQuery()
+{
+    std::vector<Body> bodies;
+    bodies.push_back(makeStaticBody(Vec3(0.0, -100.0, 0.0), 100.0));
+    for (int k = 0; k < 60; ++k) {
+        Body body = makeDynamicBody(Vec3(0.7 * (k % 10), 0.4 + 0.7 * (k / 10), 0.3 * (k % 3)), 0.5, 1.0);
+        body.sleeping = k % 3 != 0;
+        bodies.push_back(body);
+    }
+
+    std::vector<std::size_t> moving;
+    std::vector<std::size_t> inert;
+    for (std::size_t i = 0; i < bodies.size(); ++i) {
+        (bodies[i].invMass > 0.0 && !bodies[i].sleeping ? moving : inert).push_back(i);
+    }
+    sim::broadphase::Scratch scratch;
+    sim::broadphase::InertSet inertSet;
+    inertSet.build(bodies, inert, scratch);
+
+    std::vector<sim::broadphase::Pair> expected;
+    sim::broadphase::discretePairs(bodies, expected);
+    std::erase_if(expected, [&](const sim::broadphase::Pair& pair) {
+        return std::ranges::find(moving, pair.first) == moving.end() &&
+               std::ranges::find(moving, pair.second) == moving.end();
+    });
+    sim::broadphase::PairList filtered;
+    sim::broadphase::discretePairs(bodies, moving, inertSet, scratch, filtered);
+
+    std::ranges::sort(expected);
+    std::ranges::sort(filtered);
+    require(std::ranges::equal(filtered, expected),
+        "moving-versus-inert queries should find every pair of the full sweep that involves a moving body");
+}
+
+void testIslandsSleepAndWakeTogether()
+{
+    sim::World::Params params{};
+    params.enableGravity = false;
+    params.sleepTime = 0.1;
+
+    std::vector<Body> bodies;
+    bodies.push_back(makeStaticBody(Vec3(0.0, -10.0, 0.0), 9.5));
+    for (int k = 0; k < 4; ++k) {
+        bodies.push_back(makeDynamicBody(Vec3(0.95 * k, 0.0, 0.0), 0.5, 1.0));
+    }
+    Body projectile = makeDynamicBody(Vec3(-20.0, 0.0, 0.0), 0.5, 1.0);
+    bodies.push_back(projectile);
+
+    sim::World world(std::move(bodies), params);
+    for (int step = 0; step < 20; ++step) {
+        world.step(1.0 / 60.0);
+    }
+    for (std::size_t i = 1; i < 5; ++i) {
+        require(world.bodies()[i].sleeping, "a resting row of touching bodies should fall asleep");
+    }
+
+    const std::vector<Body> before = world.bodies();
+    world.step(1.0 / 60.0);
+    for (std::size_t i = 1; i < 5; ++i) {
+        require(world.bodies()[i].position.x == before[i].position.x &&
+                world.bodies()[i].position.y == before[i].position.y,
+            "sleeping islands should not be integrated");
+    }
+
+    // Fire the projectile into the far end of the row: the whole island wakes, not just the body hit.
+    world.bodies()[5].sleeping = false;
+    world.bodies()[5].position = Vec3(-1.2, 0.0, 0.0);
+    world.bodies()[5].velocity = Vec3(20.0, 0.0, 0.0);
+    world.step(1.0 / 60.0);
+    for (std::size_t i = 1; i < 5; ++i) {
+        require(!world.bodies()[i].sleeping, "a contact with one member should wake the whole island");
+    }
+}
+
+void testBodyHandlesSurviveRemoval()
+{
+    sim::World::Params params{};
+    params.enableGravity = false;
+    sim::World world(params);
+    std::vector<std::uint64_t> ids;
+    for (int k = 0; k < 5; ++k) {
+        ids.push_back(world.addBody(makeDynamicBody(Vec3(3.0 * k, 0.0, 0.0), 0.5, 1.0 + k)));
+    }
+
+    require(world.removeBody(ids[1]), "removing a live body should succeed");
+    require(!world.removeBody(ids[1]), "a removed id should stay dead");
+    require(world.indexOf(ids[1]) == sim::World::kNoBody, "a removed id should not resolve");
+    require(world.bodies().size() == 4 && world.bodies()[1].id == ids[4],
+        "removal should move the last body into the hole");
+
+    const std::uint64_t reused = world.addBody(makeDynamicBody(Vec3(0.0, 5.0, 0.0), 0.5, 1.0));
+    require(reused != ids[1] && world.indexOf(ids[1]) == sim::World::kNoBody,
+        "a reused slot should hand out a new id");
+    for (const std::uint64_t id : {ids[0], ids[2], ids[3], ids[4], reused}) {
+        const std::size_t index = world.indexOf(id);
+        require(index != sim::World::kNoBody && world.bodies()[index].id == id,
+            "live ids should resolve to their body after compaction");
+    }
+    require(std::abs(world.bodies()[world.indexOf(ids[4])].invMass - 0.2) < kRoundingTolerance,
+        "the moved body should keep its state");
+
+    // Bodies pushed straight into bodies() get ids on the next step.
+    world.bodies().push_back(makeDynamicBody(Vec3(0.0, -5.0, 0.0), 0.5, 1.0));
+    world.step(1.0 / 60.0);
+    require(world.indexOf(world.bodies().back().id) == world.bodies().size() - 1,
+        "bodies added behind the world's back should be given handles");
+}
+
+void testRemovingSupportWakesSleepers()
+{
+    sim::World::Params params{};
+    params.enableGravity = false;
+    params.sleepTime = 0.1;
+
+    std::vector<Body> bodies;
+    bodies.push_back(makeStaticBody(Vec3(0.0, -10.0, 0.0), 9.5));
+    for (int k = 0; k < 4; ++k) {
+        bodies.push_back(makeDynamicBody(Vec3(0.95 * k, 0.0, 0.0), 0.5, 1.0));
+    }
+    bodies.push_back(makeDynamicBody(Vec3(-20.0, 0.0, 0.0), 0.5, 1.0));
+    sim::World world(std::move(bodies), params);
+    for (int step = 0; step < 20; ++step) {
+        world.step(1.0 / 60.0);
+    }
+    std::vector<std::uint64_t> row;
+    for (std::size_t i = 1; i < 5; ++i) {
+        require(world.bodies()[i].sleeping, "the row should fall asleep on the ground");
+        row.push_back(world.bodies()[i].id);
+    }
+
+    require(world.removeBody(world.bodies().front().id), "the ground should be removable");
+    for (const std::uint64_t id : row) {
+        require(!world.bodies()[world.indexOf(id)].sleeping, "bodies resting on a removed body should wake");
+    }
+    for (int step = 0; step < 5; ++step) {
+        world.step(1.0 / 60.0);
+    }
+    for (const std::uint64_t id : row) {
+        const std::size_t index = world.indexOf(id);
+        require(index != sim::World::kNoBody && std::isfinite(world.bodies()[index].position.x),
+            "the woken row should keep simulating after compaction");
+    }
+}
+
+void testMortonReorderKeepsIdsAndState()
+{
+    sim::World::Params params{};
+    params.enableGravity = false;
+    params.enableCollisions = false;
+    params.reorderInterval = 1;
+
+    // A 4x4x4 grid inserted in scrambled order.
+    std::vector<Body> bodies;
+    for (int k = 0; k < 64; ++k) {
+        const int cell = (k * 37) % 64;
+        Body body = makeDynamicBody(Vec3(2.0 * (cell % 4), 2.0 * (cell / 4 % 4), 2.0 * (cell / 16)), 0.5, 1.0);
+        body.velocity = Vec3(0.1 * k, 0.0, 0.0);
+        bodies.push_back(body);
+    }
+    sim::World world(std::move(bodies), params);
+    const std::vector<Body> before = world.bodies();
+    const auto pathLength = [](const std::vector<Body>& list) {
+        double length = 0.0;
+        for (std::size_t i = 1; i < list.size(); ++i) {
+            length += (list[i].position - list[i - 1].position).magnitude();
+        }
+        return length;
+    };
+
+    constexpr double dt = 1.0 / 60.0;
+    world.step(dt);
+    require(world.reorderCount() == 1, "a scrambled scene should be reordered");
+    const auto previous = world.previousBodyIndices();
+    require(previous.size() == before.size(), "every body should report its previous index");
+    for (std::size_t i = 0; i < before.size(); ++i) {
+        const Body& moved = world.bodies()[i];
+        const Body& original = before[previous[i]];
+        require(moved.id == original.id && world.indexOf(moved.id) == i, "reordering should keep ids and handles");
+        require((moved.position - (original.position + original.velocity * dt)).magnitude() < kRoundingTolerance,
+            "bodies should carry their own state through a reorder");
+    }
+    require(pathLength(world.bodies()) < 0.5 * pathLength(before),
+        "Morton order should place spatial neighbours next to each other");
+
+    world.step(dt);
+    require(world.reorderCount() == 1, "an already sorted scene should not be reordered again");
+}
+
+void testMortonReorderKeepsSleepIslands()
+{
+    sim::World::Params params{};
+    params.enableGravity = false;
+    params.sleepTime = 0.1;
+    params.reorderInterval = 1;
+
+    // Bodies listed right to left so every reorder moves them.
+    std::vector<Body> bodies;
+    bodies.push_back(makeDynamicBody(Vec3(-20.0, 0.0, 0.0), 0.5, 1.0));
+    for (int k = 3; k >= 0; --k) {
+        bodies.push_back(makeDynamicBody(Vec3(0.95 * k, 0.0, 0.0), 0.5, 1.0));
+    }
+    bodies.push_back(makeStaticBody(Vec3(0.0, -10.0, 0.0), 9.5));
+    sim::World world(std::move(bodies), params);
+    std::vector<std::uint64_t> row;
+    for (std::size_t i = 1; i < 5; ++i) {
+        row.push_back(world.bodies()[i].id);
+    }
+    const std::uint64_t projectile = world.bodies().front().id;
+    for (int step = 0; step < 20; ++step) {
+        world.step(1.0 / 60.0);
+    }
+    require(world.reorderCount() > 0, "the scene should have been reordered");
+    for (const std::uint64_t id : row) {
+        require(world.bodies()[world.indexOf(id)].sleeping, "a reordered row should still fall asleep");
+    }
+
+    Body& shot = world.bodies()[world.indexOf(projectile)];
+    shot.sleeping = false;
+    shot.position = Vec3(4.0, 0.0, 0.0);
+    shot.velocity = Vec3(-20.0, 0.0, 0.0);
+    world.step(1.0 / 60.0);
+    for (const std::uint64_t id : row) {
+        require(!world.bodies()[world.indexOf(id)].sleeping, "islands should wake together after a reorder");
+    }
+}
+
+void testFrameArenaMergesSpillsAndShrinks()
+{
+    sim::FrameArena arena;
+    std::pmr::vector<std::byte> buffer(&arena);
+    buffer.resize(std::size_t{1} << 20);
+    buffer.resize(std::size_t{3} << 20);
+    require(arena.bytesInUse() >= (std::size_t{4} << 20), "released buffers should stay in the arena until reset");
+    std::pmr::vector<std::byte>(&arena).swap(buffer);
+    arena.reset();
+    require(arena.bytesInUse() == 0 && arena.highWaterMark() >= (std::size_t{4} << 20),
+        "reset should rewind the arena and keep the high-water mark");
+    require(arena.capacity() >= arena.highWaterMark(), "spilled blocks should be merged into one block");
+
+    const std::size_t blocks = arena.blockAllocations();
+    for (int frame = 0; frame < 10; ++frame) {
+        buffer.resize(std::size_t{1} << 20);
+        std::pmr::vector<std::byte>(&arena).swap(buffer);
+        arena.reset();
+    }
+    require(arena.blockAllocations() == blocks, "frames that fit the block should not allocate");
+
+    for (int frame = 0; frame < 300; ++frame) {
+        buffer.resize(1024);
+        std::pmr::vector<std::byte>(&arena).swap(buffer);
+        arena.reset();
+    }
+    require(arena.capacity() < (std::size_t{1} << 20), "a block much larger than recent frames should shrink");
+}
+
+void testWorldStepReusesScratchArena()
+{
+    sim::World::Params params{};
+    params.workerThreads = 1;
+    std::vector<Body> bodies;
+    bodies.push_back(makeStaticBody(Vec3(0.0, -100.0, 0.0), 100.0));
+    for (int k = 0; k < 64; ++k) {
+        bodies.push_back(makeDynamicBody(Vec3(1.0 * (k % 4), 0.5 + 1.0 * (k / 16), 1.0 * ((k / 4) % 4)), 0.5, 1.0));
+    }
+    sim::World world(std::move(bodies), params);
+    for (int step = 0; step < 30; ++step) {
+        world.step(1.0 / 60.0);
+    }
+    const sim::FrameArena& arena = world.scratchArena();
+    require(arena.bytesInUse() == 0 && arena.highWaterMark() > 0, "a step should use the arena and rewind it");
+
+    const std::size_t blocks = arena.blockAllocations();
+    for (int step = 0; step < 30; ++step) {
+        world.step(1.0 / 60.0);
+    }
+    require(arena.blockAllocations() == blocks, "steady steps should not take new blocks from the heap");
+
+    world.trimScratch();
+    require(arena.capacity() == 0, "trimming should hand the scratch memory back");
+    world.bodies().push_back(makeDynamicBody(Vec3(1.5, 6.0, 1.5), 0.5, 1.0));
+    world.step(1.0 / 60.0);
+    require(arena.highWaterMark() > 0 && arena.bytesInUse() == 0, "the arena should refill on the next step");
+}
+
+void testLazySanitizationRepairsAndCounts()
+{
+    sim::World::Params params{};
+    params.enableGravity = false;
+    params.lazySanitization = true;
+
+    std::vector<Body> bodies;
+    for (int k = 0; k < 4; ++k) {
+        bodies.push_back(makeDynamicBody(Vec3(3.0 * k, 0.0, 0.0), 0.5, 1.0));
+    }
+    sim::World world(std::move(bodies), params);
+    world.step(1.0 / 60.0);
+    require(world.repairedBodyCount() == 0, "valid bodies should not count as repaired");
+
+    world.bodies()[1].radius = -1.0;
+    world.step(1.0 / 60.0);
+    const sim::World& view = world;
+    require(view.bodies()[1].radius > 0.0 && view.repairedBodyCount() == 1,
+        "edits through bodies() should get the full checks");
+
+    // Integration spreads a NaN velocity into the position, which the scan must catch.
+    Body& body = world.bodies()[2];
+    world.step(1.0 / 60.0);
+    body.velocity.y = std::nan("");
+    world.step(1.0 / 60.0);
+    require(std::isfinite(view.bodies()[2].position.y) && std::isfinite(view.bodies()[2].velocity.y),
+        "the NaN scan should repair integrated state");
+    require(view.repairedBodyCount() == 2, "every repaired body should be counted");
+}
+
+void testLazySanitizationMatchesFull()
+{
+    const auto run = [](const bool lazy) {
+        sim::World::Params params{};
+        params.lazySanitization = lazy;
+        std::vector<Body> bodies;
+        bodies.push_back(makeStaticBody(Vec3(0.0, -100.0, 0.0), 100.0));
+        for (int k = 0; k < 27; ++k) {
+            Body body = makeDynamicBody(Vec3(1.0 * (k % 3), 0.5 + 1.0 * (k / 9), 1.0 * ((k / 3) % 3)), 0.5, 1.0);
+            body.angularVelocity = Vec3(0.3 * (k % 2), 0.0, 0.2);
+            bodies.push_back(body);
+        }
+        sim::World world(std::move(bodies), params);
+        for (int step = 0; step < 90; ++step) {
+            world.step(1.0 / 60.0);
+        }
+        return world;
+    };
+    const sim::World full = run(false);
+    const sim::World lazy = run(true);
+    for (std::size_t i = 0; i < full.bodies().size(); ++i) {
+        require((full.bodies()[i].position - lazy.bodies()[i].position).magnitude() < kDriftTolerance,
+            "skipping checks on valid bodies should not change the simulation");
+    }
+}
+
+void testTripleBufferHandsOffLatestValue()
+{
+    sim::TripleBuffer<int> buffer;
+    require(!buffer.acquire(), "nothing should be acquired before the first publish");
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+    require(buffer.acquire() && buffer.front() == 2, "the reader should get the latest publication");
+    require(!buffer.acquire() && buffer.front() == 2, "front should stay put until something new is published");
+
+    buffer.back() = 3;
+    buffer.publish();
+    require(buffer.acquire() && buffer.front() == 3, "every new publication should reach the reader");
+}
+
+void testTripleBufferKeepsSnapshotsWhole()
+{
+    // Each snapshot is a run of equal values; a torn read would mix two of them.
+    constexpr int kPublications = 20000;
+    sim::TripleBuffer<std::vector<int>> buffer;
+    std::thread writer([&buffer]() {
+        for (int value = 1; value <= kPublications; ++value) {
+            buffer.back().assign(64, value);
+            buffer.publish();
+        }
+    });
+
+    int last = 0;
+    bool whole = true;
+    bool ordered = true;
+    while (last < kPublications) {
+        if (!buffer.acquire()) {
+            std::this_thread::yield();
+            continue;
+        }
+        const std::vector<int>& snapshot = buffer.front();
+        whole = whole && snapshot.size() == 64 && std::ranges::count(snapshot, snapshot.front()) == 64;
+        ordered = ordered && snapshot.front() > last;
+        last = snapshot.front();
+    }
+    writer.join();
+    require(whole, "the reader should never see a snapshot the writer is still filling");
+    require(ordered, "snapshots should arrive in publication order");
+}
+
+void testTaskGraphRunsDependenciesFirst()
+{
+    // A diamond repeated a few times: every node checks that all of its inputs finished.
+    sim::jobs::JobSystem jobs(4);
+    sim::jobs::TaskGraph graph;
+    constexpr std::size_t kItems = 4096;
+    std::vector<int> a(kItems, 0);
+    std::vector<int> b(kItems, 0);
+    std::vector<int> c(kItems, 0);
+    std::atomic<int> sum{0};
+    std::atomic<bool> ordered{true};
+    for (int round = 0; round < 20; ++round) {
+        graph.clear();
+        std::ranges::fill(a, 0);
+        std::ranges::fill(b, 0);
+        std::ranges::fill(c, 0);
+        sum = 0;
+        const auto fillA = graph.add(kItems, 256, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) {
+                a[k] = 1;
+            }
+        });
+        const auto fillB = graph.add(kItems, 256, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) {
+                b[k] = a[k] + 1;
+            }
+        }, {fillA});
+        const auto fillC = graph.add(kItems, 512, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) {
+                c[k] = a[k] + 2;
+            }
+        }, {fillA});
+        graph.addTask([&]() {
+            int total = 0;
+            for (std::size_t k = 0; k < kItems; ++k) {
+                total += b[k] + c[k];
+            }
+            sum = total;
+        }, {fillB, fillC});
+        graph.add(0, 1, [&](std::size_t, std::size_t) { ordered = false; }, {fillC});
+        jobs.run(graph);
+        ordered = ordered && sum == static_cast<int>(5 * kItems);
+    }
+    require(graph.size() == 5, "clear should let the same graph be rebuilt");
+    require(ordered, "nodes should start only after every node they depend on finished");
+
+    bool threw = false;
+    try {
+        graph.clear();
+        graph.addTask([]() {}, {0});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    require(threw, "a node should only depend on nodes added before it");
+}
+
+void testThreadedStepPhasesMatchSerial()
+{
+    // Enough awake bodies that the per-body phases split into several chunks.
+    const auto run = [](const int threads) {
+        sim::World::Params params{};
+        params.G = 1e-3;
+        params.workerThreads = threads;
+        params.lazySanitization = true;
+        std::vector<Body> bodies;
+        bodies.push_back(makeStaticBody(Vec3(0.0, -200.0, 0.0), 190.0));
+        for (int k = 0; k < 2600; ++k) {
+            Body body = makeDynamicBody(Vec3(1.1 * (k % 20), 0.6 + 1.1 * (k / 400), 1.1 * ((k / 20) % 20)), 0.5, 1.0);
+            body.angularVelocity = Vec3(0.0, 0.1 * (k % 3), 0.0);
+            bodies.push_back(body);
+        }
+        sim::World world(std::move(bodies), params);
+        for (int step = 0; step < 6; ++step) {
+            if (step == 3) {
+                world.bodies()[1500].velocity.x = std::numeric_limits<sim::Real>::infinity();
+            }
+            world.step(1.0 / 60.0);
+        }
+        return world;
+    };
+    const sim::World serial = run(1);
+    const sim::World threaded = run(4);
+    bool same = true;
+    for (std::size_t i = 0; i < serial.bodies().size(); ++i) {
+        const Body& s = serial.bodies()[i];
+        const Body& t = threaded.bodies()[i];
+        same = same && s.position.x == t.position.x && s.position.y == t.position.y &&
+               s.position.z == t.position.z && s.velocity.x == t.velocity.x &&
+               s.velocity.y == t.velocity.y && s.velocity.z == t.velocity.z &&
+               s.orientation.w == t.orientation.w && s.sleeping == t.sleeping;
+    }
+    require(same, "running the step phases on a pool should reproduce the single-thread result exactly");
+    require(serial.repairedBodyCount() == threaded.repairedBodyCount() && serial.repairedBodyCount() > 0,
+        "repairs made on workers should all be counted");
+}
+
+void testDeterministicModeIgnoresThreadCount()
+{
+    // Large enough that the contact solve partitions and colors its pairs.
+    const auto makeWorld = [](const int threads) {
+        sim::World::Params params{};
+        params.enableGravity = false;
+        params.deterministic = true;
+        params.workerThreads = threads;
+        params.velocityIterations = 6;
+        return sim::World(makeSinglePile(7), params);
+    };
+    sim::World serial = makeWorld(1);
+    sim::World threaded = makeWorld(3);
+    bool same = true;
+    for (int step = 0; step < 60; ++step) {
+        serial.step(1.0 / 60.0);
+        threaded.step(1.0 / 60.0);
+        same = same && serial.stateHash() == threaded.stateHash();
+    }
+    require(same, "deterministic mode should give the same state hash for every pool size");
+    const auto& a = std::as_const(serial).bodies();
+    const auto& b = std::as_const(threaded).bodies();
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        same = same && a[i].position.x == b[i].position.x && a[i].position.y == b[i].position.y &&
+               a[i].position.z == b[i].position.z && a[i].sleeping == b[i].sleeping;
+    }
+    require(same, "matching hashes should mean bit-identical bodies");
+}
+
+void testStateHashTracksMovedBodies()
+{
+    // One world refreshes its hash from moved bodies only; the other is forced to rehash every
+    // body each step by handing out its bodies.
+    const auto makeWorld = []() {
+        sim::World::Params params{};
+        params.deterministic = true;
+        params.enableGravity = false;
+        std::vector<Body> bodies;
+        bodies.push_back(makeStaticBody(Vec3(0.0, -10.0, 0.0), 10.0));
+        for (int k = 0; k < 6; ++k) {
+            Body body = makeDynamicBody(Vec3(3.0 * k, 0.6, 0.0), 0.5, 1.0);
+            body.velocity = Vec3(0.0, -0.5 * (k % 2), 0.0);
+            bodies.push_back(body);
+        }
+        return sim::World(std::move(bodies), params);
+    };
+    sim::World incremental = makeWorld();
+    sim::World rehashed = makeWorld();
+    bool same = true;
+    bool changed = false;
+    std::uint64_t previous = incremental.stateHash();
+    for (int step = 0; step < 120; ++step) {
+        (void)rehashed.bodies();
+        incremental.step(1.0 / 60.0);
+        rehashed.step(1.0 / 60.0);
+        same = same && incremental.stateHash() == rehashed.stateHash();
+        changed = changed || incremental.stateHash() != previous;
+        previous = incremental.stateHash();
+    }
+    require(incremental.bodies()[1].sleeping, "the scene should have settled and fallen asleep");
+    require(same, "the incremental hash should equal a full rehash, through bodies falling asleep");
+    require(changed, "stepping moving bodies should change the hash");
+
+    const std::uint64_t before = incremental.stateHash();
+    incremental.removeBody(incremental.bodies()[3].id);
+    require(incremental.stateHash() != before, "removing a body should change the hash");
+
+    // Steps outside deterministic mode leave the kept hash behind; it must not be served after.
+    sim::World toggled = makeWorld();
+    toggled.bodies()[2].velocity = Vec3(1.0, 0.0, 0.0);
+    toggled.step(1.0 / 60.0);
+    const std::uint64_t deterministicHash = toggled.stateHash();
+    toggled.params().deterministic = false;
+    toggled.advance(10, 1.0 / 60.0);
+    const std::uint64_t afterLooseSteps = toggled.stateHash();
+    (void)toggled.bodies();
+    require(afterLooseSteps != deterministicHash && afterLooseSteps == toggled.stateHash(),
+        "steps with deterministic off should drop the kept hash");
+    toggled.params().deterministic = true;
+    toggled.step(1.0 / 60.0);
+    const std::uint64_t backOn = toggled.stateHash();
+    (void)toggled.bodies();
+    require(backOn == toggled.stateHash(), "turning deterministic mode back on should rebuild the hash");
+}
+
+void testAdvanceMatchesRepeatedSteps()
+{
+    const auto makeWorld = []() {
+        sim::World::Params params{};
+        params.G = 1e-2;
+        params.deterministic = true;
+        std::vector<Body> bodies = makeSinglePile(4);
+        bodies[5].velocity = Vec3(0.0, -30.0, 0.0);
+        return sim::World(std::move(bodies), params);
+    };
+    constexpr int kSteps = 45;
+    constexpr double kDt = 1.0 / 30.0;
+    sim::World stepped = makeWorld();
+    sim::World advanced = makeWorld();
+    for (int step = 0; step + 1 < kSteps; ++step) {
+        stepped.step(kDt);
+    }
+    const std::vector<Body> beforeLast = std::as_const(stepped).bodies();
+    stepped.step(kDt);
+    const sim::World::StepStats stats = advanced.advance(kSteps, kDt);
+    const auto& bodies = std::as_const(advanced).bodies();
+
+    require(stats.steps == kSteps && stats.substeps == 2 * kSteps,
+        "advance should report every step and the substeps the world chose");
+    require(std::abs(stats.simulatedTime - kSteps * kDt) < kRoundingTolerance, "simulated time should add up");
+    require(stats.awakeBodySteps == static_cast<std::uint64_t>(stats.substeps) * bodies.size() - stats.substeps,
+        "every dynamic body should have been awake for every substep");
+    require(stepped.stateHash() == advanced.stateHash(), "advance should give the same result as repeated steps");
+    bool interpolatable = true;
+    for (std::size_t i = 0; i < bodies.size(); ++i) {
+        interpolatable = interpolatable && bodies[i].prevPosition.x == beforeLast[i].position.x &&
+                         bodies[i].prevPosition.y == beforeLast[i].position.y &&
+                         bodies[i].prevOrientation.w == beforeLast[i].orientation.w;
+    }
+    require(interpolatable, "prev state should be the state before the last step");
+    require(advanced.advance(0, kDt).steps == 0, "advancing zero steps should do nothing");
+
+    sim::World::Params smallParams{};
+    smallParams.smallStepSolver = true;
+    smallParams.smallSteps = 4;
+    smallParams.enableSleeping = false;
+    sim::World small(makeSinglePile(4), smallParams);
+    const sim::World::StepStats smallStats = small.advance(kSteps, kDt);
+    const std::uint64_t dynamicBodies = std::as_const(small).bodies().size() - 1;
+    require(smallStats.substeps == 4 * kSteps && smallStats.awakeBodySteps == smallStats.substeps * dynamicBodies,
+        "the small-step solver should count every awake body once per small step");
+}
+
+
+void testAdaptiveSubstepsFollowTimeScales()
+{
+    // A calm pair far apart: one substep covers a step four times maxSubstepDt, and the
+    // symmetric variant, which measures at a predicted state, leaves no trace of it.
+    const auto makeCalmWorld = [](const bool symmetric) {
+        sim::World::Params params{};
+        params.G = 1e-3;
+        params.adaptiveSubsteps = true;
+        params.symmetricSubsteps = symmetric;
+        std::vector<Body> bodies{makeDynamicBody(Vec3(0.0, 0.0, 0.0), 1.0, 1.0),
+                                 makeDynamicBody(Vec3(50.0, 0.0, 0.0), 1.0, 1.0)};
+        bodies[1].velocity = Vec3(0.0, 0.1, 0.0);
+        return sim::World(std::move(bodies), params);
+    };
+    constexpr double kLongDt = 4.0 / 60.0;
+    sim::World plain = makeCalmWorld(false);
+    sim::World symmetric = makeCalmWorld(true);
+    const sim::World::StepStats calm = plain.advance(3, kLongDt);
+    symmetric.advance(3, kLongDt);
+    require(calm.substeps == 3 && std::abs(plain.lastSubstepDt() - kLongDt) < kRoundingTolerance,
+        "a calm step should run as a single substep");
+    require(std::as_const(plain).bodies()[1].position.y == std::as_const(symmetric).bodies()[1].position.y &&
+                std::as_const(plain).bodies()[1].velocity.x == std::as_const(symmetric).bodies()[1].velocity.x,
+        "the symmetric prediction should restore the state it measured");
+
+    // An eccentric orbit (e = 0.9) of a light body around a heavy one, for one period.
+    const auto makeOrbit = [](const bool adaptive, const bool symmetric = false) {
+        sim::World::Params params{};
+        params.G = 1.0;
+        params.enableCollisions = false;
+        params.adaptiveSubsteps = adaptive;
+        params.symmetricSubsteps = symmetric;
+        constexpr double kApoapsis = 19.0;
+        std::vector<Body> bodies{makeDynamicBody(Vec3(0.0, 0.0, 0.0), 0.1, 1000.0),
+                                 makeDynamicBody(Vec3(kApoapsis, 0.0, 0.0), 0.1, 1.0)};
+        bodies[1].velocity = Vec3(0.0, std::sqrt(1000.0 * 0.1 / kApoapsis), 0.0);
+        bodies[0].velocity = bodies[1].velocity * -1e-3;
+        return sim::World(std::move(bodies), params);
+    };
+    const auto energy = [](const sim::World& world) {
+        const auto& bodies = world.bodies();
+        double kinetic = 0.0;
+        for (const Body& body : bodies) {
+            kinetic += 0.5 * body.velocity.dot(body.velocity) / body.invMass;
+        }
+        return kinetic - 1000.0 / (bodies[1].position - bodies[0].position).magnitude();
+    };
+    constexpr double kSemiMajorAxis = 10.0;
+    const double period = 2.0 * 3.14159265358979 * std::sqrt(kSemiMajorAxis * kSemiMajorAxis * kSemiMajorAxis / 1000.0);
+    constexpr double kDt = 1.0 / 60.0;
+    const int steps = static_cast<int>(period / kDt);
+    sim::World fixed = makeOrbit(false);
+    sim::World adaptive = makeOrbit(true);
+    const double initialEnergy = energy(adaptive);
+    fixed.advance(steps, kDt);
+    int substeps = 0;
+    double minSubstepDt = kDt;
+    double maxSubstepDt = 0.0;
+    double adaptivePeakError = 0.0;
+    for (int step = 0; step < steps; ++step) {
+        const sim::World::StepStats stats = adaptive.advance(1, kDt);
+        substeps += stats.substeps;
+        minSubstepDt = std::min<double>(minSubstepDt, stats.minSubstepDt);
+        maxSubstepDt = std::max<double>(maxSubstepDt, stats.maxSubstepDt);
+        adaptivePeakError = std::max(adaptivePeakError, std::abs(energy(adaptive) - initialEnergy));
+    }
+    const double fixedError = std::abs(energy(fixed) - initialEnergy);
+    const double adaptiveError = std::abs(energy(adaptive) - initialEnergy);
+
+    require(maxSubstepDt > 4.0 * minSubstepDt, "periapsis should get much shorter substeps than apoapsis");
+    require(substeps * minSubstepDt < steps * kDt, "adaptive substeps should average longer than the shortest one they needed");
+    require(adaptiveError < 0.1 * fixedError && adaptiveError < 1e-4 * std::abs(initialEnergy),
+        "adaptive substeps should follow the orbit much more closely than fixed ones");
+
+    // Even substeps, at least as many as adaptive took, still stray much further at periapsis.
+    const int evenSubsteps = (substeps + steps - 1) / steps;
+    sim::World even = makeOrbit(false);
+    double evenPeakError = 0.0;
+    for (int step = 0; step < steps; ++step) {
+        even.advance(evenSubsteps, kDt / evenSubsteps);
+        evenPeakError = std::max(evenPeakError, std::abs(energy(even) - initialEnergy));
+    }
+    require(adaptivePeakError < 0.25 * evenPeakError,
+        "fixed substeps should need several times as many substeps as adaptive ones for the same accuracy");
+
+    // Run forward, reverse the velocities and run back: symmetric substeps retrace the orbit to
+    // where it started far more closely. Single precision rounding hides the difference.
+    const auto reversalError = [&](const bool symmetric) {
+        sim::World world = makeOrbit(true, symmetric);
+        world.params().adaptiveTolerance = 0.2;
+        const Vec3 start = std::as_const(world).bodies()[1].position;
+        world.advance(steps, kDt);
+        for (Body& body : world.bodies()) {
+            body.velocity = body.velocity * -1.0;
+        }
+        world.advance(steps, kDt);
+        return (std::as_const(world).bodies()[1].position - start).magnitude();
+    };
+    const double plainReversal = reversalError(false);
+    const double symmetricReversal = reversalError(true);
+    require(symmetricReversal < (kSinglePrecision ? 1e-2 : 1e-4),
+        "a symmetric orbit run forward and back should end where it started");
+    require(kSinglePrecision || symmetricReversal < 0.5 * plainReversal,
+        "symmetric substeps should retrace an orbit more closely than plain adaptive ones");
+}
+
+void testEnsembleMatchesIndependentWorlds()
+{
+    const auto makeMember = [](const std::size_t index) {
+        sim::World world = sim::makeDefaultWorld();
+        for (Body& body : world.bodies()) {
+            body.velocity = body.velocity * (1.0 + 0.01 * static_cast<double>(index));
+        }
+        return world;
+    };
+    constexpr std::size_t kMembers = 7;
+    constexpr int kSteps = 30;
+    constexpr double kDt = 1.0 / 60.0;
+    sim::Ensemble ensemble(3);
+    for (std::size_t m = 0; m < kMembers; ++m) {
+        require(ensemble.add(makeMember(m)) == m, "members should be numbered in the order they were added");
+    }
+    ensemble.member(2).params().workerThreads = 4;
+    const sim::Ensemble::Stats first = ensemble.advance(kSteps / 2, kDt);
+    const sim::Ensemble::Stats second = ensemble.advance(kSteps - kSteps / 2, kDt);
+
+    require(first.memberSteps == kMembers * (kSteps / 2) && second.members == kMembers,
+        "ensemble stats should count every member's steps");
+    require(first.awakeBodySteps > 0 && first.wallSeconds > 0.0 && first.bodyStepsPerSecond() > 0.0,
+        "ensemble stats should report throughput");
+    bool matches = true;
+    bool distinct = true;
+    for (std::size_t m = 0; m < kMembers; ++m) {
+        sim::World alone = makeMember(m);
+        for (int step = 0; step < kSteps; ++step) {
+            alone.step(kDt);
+        }
+        const sim::Ensemble::MemberSummary& summary = ensemble.summary(m);
+        double kineticEnergy = 0.0;
+        for (const Body& body : std::as_const(alone).bodies()) {
+            kineticEnergy += 0.5 * body.velocity.dot(body.velocity) / body.invMass;
+        }
+        matches = matches && summary.steps == kSteps && summary.stateHash == alone.stateHash() &&
+                  std::abs(summary.kineticEnergy - kineticEnergy) <= kDriftTolerance * kineticEnergy &&
+                  std::abs(summary.simulatedTime - kSteps * kDt) < kRoundingTolerance;
+        distinct = distinct && (m == 0 || summary.stateHash != ensemble.summary(m - 1).stateHash);
+    }
+    require(matches, "every member should end where it would stepping alone");
+    require(distinct, "members should not share state");
+    require(ensemble.member(2).params().workerThreads == 1, "members should run single-threaded inside the pool");
+}
+
+void testSessionSchedulerPacesSessions()
+{
+    sim::SessionScheduler::Params params{};
+    params.frameBudget = 10.0;
+    sim::SessionScheduler scheduler(params);
+    const auto normal = scheduler.addSession(sim::makeDefaultWorld(), 1.0, 0.0);
+    const auto fast = scheduler.addSession(sim::makeDefaultWorld(), 2.0, 0.0);
+    const auto paused = scheduler.addSession(sim::makeDefaultWorld(), 0.0, 0.0);
+    for (int tick = 1; tick <= 10; ++tick) {
+        scheduler.tick(0.1 * tick + 1e-6);
+    }
+
+    require(scheduler.metrics(normal).steps == 60 && scheduler.metrics(fast).steps == 120 &&
+                scheduler.metrics(paused).steps == 0,
+        "sessions should be stepped at their own speeds");
+    require(scheduler.metrics(fast).lag < params.stepDt && scheduler.metrics(normal).deadlineMisses == 0 &&
+                scheduler.metrics(normal).maxLatency > 0.0 && scheduler.metrics(normal).wallCostPerStep > 0.0,
+        "a generous budget should keep every session on time and measured");
+    require(scheduler.removeSession(fast) && !scheduler.contains(fast) && !scheduler.removeSession(fast) &&
+                scheduler.size() == 2 && scheduler.metrics(paused).steps == 0,
+        "removing a session should leave the others in place");
+}
+
+void testSessionSchedulerDegradesHeavySessions()
+{
+    sim::SessionScheduler::Params params{};
+    params.workerThreads = 2;
+    params.frameBudget = 1e-6;
+    params.recoverTicks = 2;
+    sim::SessionScheduler scheduler(params);
+    sim::World::Params heavyParams{};
+    heavyParams.enableGravity = false;
+    const auto heavy = scheduler.addSession(sim::World(makeSinglePile(6), heavyParams), 1.0, 0.0);
+    std::vector<sim::SessionScheduler::SessionId> light;
+    for (int k = 0; k < 3; ++k) {
+        light.push_back(scheduler.addSession(sim::makeDefaultWorld(), 1.0, 0.0));
+    }
+    bool lightProgress = true;
+    bool droppedBeforeLastLevel = false;
+    double now = 0.0;
+    for (int tick = 0; tick < 8; ++tick) {
+        now += 0.2;
+        std::vector<std::uint64_t> before;
+        for (const auto id : light) {
+            before.push_back(scheduler.metrics(id).steps);
+        }
+        const int levelBefore = scheduler.metrics(heavy).degradeLevel;
+        const double droppedBefore = scheduler.metrics(heavy).droppedSimTime;
+        scheduler.tick(now);
+        for (std::size_t k = 0; k < light.size(); ++k) {
+            lightProgress = lightProgress && scheduler.metrics(light[k]).steps > before[k];
+        }
+        droppedBeforeLastLevel = droppedBeforeLastLevel ||
+            (levelBefore < sim::SessionScheduler::Params::kMaxDegradeLevel &&
+                scheduler.metrics(heavy).droppedSimTime != droppedBefore);
+    }
+    const sim::SessionScheduler::SessionMetrics& metrics = scheduler.metrics(heavy);
+    require(lightProgress, "light sessions should move every tick next to a heavy one");
+    require(metrics.degradeLevel == sim::SessionScheduler::Params::kMaxDegradeLevel &&
+                scheduler.world(heavy).params().maxSubsteps == 1 &&
+                scheduler.world(heavy).params().maxCcdIterationsPerStep == 1,
+        "a session that keeps missing its deadline should be degraded step by step");
+    require(metrics.deadlineMisses > 0 && metrics.droppedSimTime > 0.0 && metrics.lag > 0.0,
+        "an overloaded session should report missed deadlines and dropped time");
+    require(!droppedBeforeLastLevel, "time should only be dropped once degrading has run out of levels");
+
+    // Nothing owed and nothing late: the session recovers a level every recoverTicks ticks.
+    scheduler.setSimSpeed(heavy, 0.0);
+    for (int tick = 0; tick < 2 * params.recoverTicks * sim::SessionScheduler::Params::kMaxDegradeLevel; ++tick) {
+        scheduler.tick(now);
+    }
+    require(scheduler.metrics(heavy).degradeLevel == 0 &&
+                scheduler.world(heavy).params().maxSubsteps == heavyParams.maxSubsteps &&
+                scheduler.world(heavy).params().maxCcdIterationsPerStep == heavyParams.maxCcdIterationsPerStep,
+        "a recovered session should get its own settings back");
+}
+
+void testPararealMatchesSerialOrbits()
+{
+    const auto makeOrbits = []() {
+        sim::World world = sim::makeDefaultWorld();
+        world.params().enableCollisions = false;
+        return world;
+    };
+    constexpr int kSteps = 960;
+    constexpr double kDt = 1.0 / 60.0;
+    sim::World serial = makeOrbits();
+    serial.advance(kSteps, kDt);
+    const auto largestError = [&serial](const sim::World& world) {
+        double error = 0.0;
+        for (std::size_t i = 0; i < world.bodies().size(); ++i) {
+            const Body& body = world.bodies()[i];
+            error = std::max(error, static_cast<double>((body.position - serial.bodies()[i].position).magnitude() / body.radius));
+        }
+        return error;
+    };
+
+    sim::Parareal::Params params{};
+    params.slices = 8;
+    params.workerThreads = 3;
+    sim::Parareal parareal(params);
+    sim::World converged = makeOrbits();
+    const sim::Parareal::Stats stats = parareal.advance(converged, kSteps, kDt);
+    require(stats.converged && stats.iterations < params.slices && stats.criticalPathFineSteps < kSteps / 2,
+        "parareal should converge on smooth orbits well before running every slice in sequence");
+    require(largestError(converged) < (kSinglePrecision ? 1e-3 : 1e-6), "converged parareal should follow serial stepping");
+
+    params.tolerance = 0.0;
+    sim::Parareal exhaustive(params);
+    sim::World exact = makeOrbits();
+    const sim::Parareal::Stats exactStats = exhaustive.advance(exact, kSteps, kDt);
+    require(exactStats.iterations == params.slices && exactStats.fineSteps > kSteps,
+        "with no tolerance parareal should iterate once per slice");
+    require(largestError(exact) <= kRoundingTolerance, "after one iteration per slice parareal should equal serial stepping");
+
+    // A body asleep in the source world moves in the propagators and comes back awake.
+    sim::World dozing = makeOrbits();
+    dozing.bodies()[1].sleeping = true;
+    parareal.advance(dozing, kSteps / params.slices, kDt);
+    const Vec3 landed = std::as_const(dozing).bodies()[1].position;
+    dozing.step(kDt);
+    require(!std::as_const(dozing).bodies()[1].sleeping && std::as_const(dozing).bodies()[1].position.x != landed.x,
+        "bodies parareal moved should be written back awake");
 }
 
 } // namespace
@@ -190,4 +1631,41 @@ void appendPhysicsCoreTests(test_registry::TestList& tests)
     tests.emplace_back("sleeping_and_warm_start", testSleepingAndWarmStart);
     tests.emplace_back("sanitization_removes_invalid_state", testSanitizationRemovesInvalidState);
     tests.emplace_back("boundary_sanitization_repairs_invalid_bodies", testBoundarySanitizationRepairsInvalidBodies);
+    tests.emplace_back("contact_island_partition", testContactIslandPartition);
+    tests.emplace_back("parallel_island_solve_matches_serial", testParallelIslandSolveMatchesSerial);
+    tests.emplace_back("contact_pair_coloring", testContactPairColoring);
+    tests.emplace_back("colored_solve_is_thread_count_independent", testColoredSolveIsThreadCountIndependent);
+    tests.emplace_back("prepared_contact_matches_pair_solver", testPreparedContactMatchesPairSolver);
+    tests.emplace_back("wide_contact_solver_matches_scalar", testWideContactSolverMatchesScalar);
+    tests.emplace_back("wide_lane_widths_agree_in_world", testWideLaneWidthsAgreeInWorld);
+    tests.emplace_back("accumulated_impulses_stay_inside_cone", testAccumulatedImpulsesStayInsideCone);
+    tests.emplace_back("accumulated_impulses_settle_stack", testAccumulatedImpulsesSettleStack);
+    tests.emplace_back("flat_pair_map_insert_find_erase", testFlatPairMapInsertFindErase);
+    tests.emplace_back("inert_broadphase_matches_full_query", testInertBroadphaseMatchesFullQuery);
+    tests.emplace_back("islands_sleep_and_wake_together", testIslandsSleepAndWakeTogether);
+    tests.emplace_back("small_step_solver_rests_tall_stack", testSmallStepSolverRestsTallStack);
+    tests.emplace_back("small_step_solver_stops_fast_body", testSmallStepSolverStopsFastBody);
+    tests.emplace_back("split_impulse_separates_without_velocity", testSplitImpulseSeparatesWithoutVelocity);
+    tests.emplace_back("gravity_matches_pairwise_sum", testGravityMatchesPairwiseSum);
+    tests.emplace_back("material_handles_drive_contact_parameters", testMaterialHandlesDriveContactParameters);
+    tests.emplace_back("body_handles_survive_removal", testBodyHandlesSurviveRemoval);
+    tests.emplace_back("removing_support_wakes_sleepers", testRemovingSupportWakesSleepers);
+    tests.emplace_back("morton_reorder_keeps_ids_and_state", testMortonReorderKeepsIdsAndState);
+    tests.emplace_back("morton_reorder_keeps_sleep_islands", testMortonReorderKeepsSleepIslands);
+    tests.emplace_back("frame_arena_merges_spills_and_shrinks", testFrameArenaMergesSpillsAndShrinks);
+    tests.emplace_back("world_step_reuses_scratch_arena", testWorldStepReusesScratchArena);
+    tests.emplace_back("lazy_sanitization_repairs_and_counts", testLazySanitizationRepairsAndCounts);
+    tests.emplace_back("lazy_sanitization_matches_full", testLazySanitizationMatchesFull);
+    tests.emplace_back("triple_buffer_hands_off_latest_value", testTripleBufferHandsOffLatestValue);
+    tests.emplace_back("triple_buffer_keeps_snapshots_whole", testTripleBufferKeepsSnapshotsWhole);
+    tests.emplace_back("task_graph_runs_dependencies_first", testTaskGraphRunsDependenciesFirst);
+    tests.emplace_back("threaded_step_phases_match_serial", testThreadedStepPhasesMatchSerial);
+    tests.emplace_back("deterministic_mode_ignores_thread_count", testDeterministicModeIgnoresThreadCount);
+    tests.emplace_back("state_hash_tracks_moved_bodies", testStateHashTracksMovedBodies);
+    tests.emplace_back("advance_matches_repeated_steps", testAdvanceMatchesRepeatedSteps);
+    tests.emplace_back("adaptive_substeps_follow_time_scales", testAdaptiveSubstepsFollowTimeScales);
+    tests.emplace_back("ensemble_matches_independent_worlds", testEnsembleMatchesIndependentWorlds);
+    tests.emplace_back("session_scheduler_paces_sessions", testSessionSchedulerPacesSessions);
+    tests.emplace_back("session_scheduler_degrades_heavy_sessions", testSessionSchedulerDegradesHeavySessions);
+    tests.emplace_back("parareal_matches_serial_orbits", testPararealMatchesSerialOrbits);
 }
@@ -16,11 +16,14 @@ int main()
 {
     TestList tests;
     appendPhysicsCoreTests(tests);
+#ifndef PHYSICS3D_SIM_SINGLE_PRECISION
+    // The app layer only builds against the double-precision core.
     appendUiPauseMenuTests(tests);
     appendMinimapTests(tests);
     appendRenderMaterialTests(tests);
     appendSceneLightingTests(tests);
     appendFocusCameraTests(tests);
+#endif
 
     int failures = 0;
     for (const auto& [name, test] : tests) {